@@ -0,0 +1,114 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/array>
+#include <ds/stack>
+#include "../counter"
+
+template class ds::Array<int>;
+template class ds::Array<int,ds::allocators::NTMalloc>;
+
+template <class A, size_t size_>
+static bool
+same_values(A const & array_, int const (& expected_)[size_])
+{
+	if(array_.size() != size_)
+		return false;
+	for(size_t i = 0; i < size_; ++i)
+		if(array_[i] != expected_[i])
+			return false;
+	return true;
+}
+
+Test(array_test)
+{
+	TestInit(array_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(append_relocatable_in_place)
+	{
+		auto array_ = ds::Array<int>({ 1, 2, 3 });
+		array_ += ds::Array<int>({ 4, 5 });
+		ExpectTrue(same_values(array_, { 1, 2, 3, 4, 5 }));
+		auto other_ = ds::Array<int>({ 6 });
+		array_ += other_;
+		ExpectTrue(same_values(array_, { 1, 2, 3, 4, 5, 6 }));
+		ExpectTrue(same_values(other_, { 6 }));
+	} TestcaseEnd(append_relocatable_in_place);
+
+	Testcase(append_through_reallocate)
+	{
+		auto array_ = ds::Array<int,ds::allocators::NTMalloc>({ 0 });
+		auto one_   = ds::Array<int>({ 0 });
+		for(int i = 1; i < 2000; ++i)
+		{
+			one_[0] = i;
+			array_ += one_;
+		}
+		AssertEQ(array_.size(), 2000);
+		bool same_ = true;
+		for(size_t i = 0; i < 2000; ++i)
+			same_ = same_ && array_[i] == int(i);
+		ExpectTrue(same_);
+	} TestcaseEnd(append_through_reallocate);
+
+	Testcase(append_to_itself)
+	{
+		auto array_ = ds::Array<int,ds::allocators::NTMalloc>({ 1, 2 });
+		array_ += array_;
+		ExpectTrue(same_values(array_, { 1, 2, 1, 2 }));
+	} TestcaseEnd(append_to_itself);
+
+	Testcase(append_to_null_array)
+	{
+		auto array_ = ds::Array<int>();
+		array_ += ds::Array<int>({ 1, 2 });
+		ExpectTrue(same_values(array_, { 1, 2 }));
+	} TestcaseEnd(append_to_null_array);
+
+	Testcase(append_relocatable_owning_elements)
+	{
+		auto array_ = ds::Array<ds::Stack<int>,ds::allocators::NTMalloc>(size_t(3), [] { return ds::Stack<int>({ 7, 8 }); });
+		auto more_  = ds::Array<ds::Stack<int>>(size_t(50), [] { return ds::Stack<int>({ 9 }); });
+		array_ += ds::move(more_);
+		AssertEQ(array_.size(), 53);
+		ExpectEQ(array_[0].size(), 2);
+		ExpectEQ(array_[2].top(), 8);
+		ExpectEQ(array_[52].top(), 9);
+	} TestcaseEnd(append_relocatable_owning_elements);
+
+	Testcase(append_non_relocatable_elements)
+	{
+		{
+			auto array_ = ds::Array<Counter>(size_t(3), 1);
+			array_ += ds::Array<Counter>(size_t(4), 2);
+			AssertEQ(array_.size(), 7);
+			ExpectEQ(array_[2].value(), 1);
+			ExpectEQ(array_[3].value(), 2);
+			ExpectEQ(Counter::active(), 7);
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(append_non_relocatable_elements);
+
+};
+
+TestRegistry(array_test)
+{
+	Register(append_relocatable_in_place)
+	Register(append_through_reallocate)
+	Register(append_to_itself)
+	Register(append_to_null_array)
+	Register(append_relocatable_owning_elements)
+	Register(append_non_relocatable_elements)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return array_test().run_all(reporter_t<array_test>(pptest::normal));
+}
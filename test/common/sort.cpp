@@ -0,0 +1,296 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/array>
+#include "../counter"
+#include "../random"
+#include "../keyed"
+
+using array_t = ds::Array<int>;
+
+enum class Pattern
+{
+	random,
+	few_distinct,
+	sorted,
+	reversed,
+	all_equal,
+	organ_pipe,
+	sawtooth,
+	nearly_sorted,
+	sorted_tail_swapped,
+	interleaved,
+};
+
+static Pattern const patterns_[] {
+	Pattern::random,
+	Pattern::few_distinct,
+	Pattern::sorted,
+	Pattern::reversed,
+	Pattern::all_equal,
+	Pattern::organ_pipe,
+	Pattern::sawtooth,
+	Pattern::nearly_sorted,
+	Pattern::sorted_tail_swapped,
+	Pattern::interleaved,
+};
+
+static size_t const sizes_[] { 0, 1, 2, 3, 4, 5, 23, 24, 25, 127, 128, 129, 1000, 4099, 100000 };
+
+// size_ values in [0,size_) laid out in pattern_
+static array_t
+make_pattern(Pattern pattern_, size_t size_, uint32_t seed_ = 1)
+{
+	auto array_ = array_t(size_, 0);
+	int const n = int(size_);
+	for(int i = 0; i < n; ++i)
+	{
+		int & value_ = array_[size_t(i)];
+		switch(pattern_)
+		{
+		case Pattern::random:              value_ = int(next_random(seed_) % size_); break;
+		case Pattern::few_distinct:        value_ = int(next_random(seed_) % 4); break;
+		case Pattern::sorted:              value_ = i; break;
+		case Pattern::reversed:            value_ = n - 1 - i; break;
+		case Pattern::all_equal:           value_ = n / 2; break;
+		case Pattern::organ_pipe:          value_ = i < n / 2 ? 2 * i : 2 * (n - 1 - i) + 1; break;
+		case Pattern::sawtooth:            value_ = i % ds::max(1, n / 8); break;
+		case Pattern::nearly_sorted:       value_ = i; break;
+		case Pattern::sorted_tail_swapped: value_ = i; break;
+		case Pattern::interleaved:         value_ = i % 2 == 0 ? i / 2 : n - 1 - i / 2; break;
+		}
+	}
+	if(pattern_ == Pattern::nearly_sorted)
+		for(size_t i = 0; i < size_ / 64 + 1 && size_ > 1; ++i)
+			ds::swap(array_[next_random(seed_) % size_], array_[next_random(seed_) % size_]);
+	if(pattern_ == Pattern::sorted_tail_swapped && size_ > 1)
+		ds::swap(array_[0], array_[size_ - 1]);
+	return array_;
+}
+
+template <class C>
+static bool
+is_sorted(array_t const & array_, C && compare)
+{
+	for(size_t i = 1; i < array_.size(); ++i)
+		if(compare(array_[i], array_[i - 1]))
+			return false;
+	return true;
+}
+
+// same values as original_, every one of them in [0,size)
+static bool
+is_permutation(array_t const & sorted_, array_t const & original_)
+{
+	if(sorted_.size() != original_.size())
+		return false;
+	auto counts_ = array_t(original_.size() + 1, 0);
+	for(int value_ : original_)
+		++counts_[size_t(value_)];
+	for(int value_ : sorted_)
+		if(value_ < 0 || size_t(value_) >= counts_.size() || counts_[size_t(value_)]-- == 0)
+			return false;
+	return true;
+}
+
+// a comparator the branchless partition does not apply to, counting its calls
+struct CountingLess
+{
+	size_t * calls;
+
+	inline bool
+	operator()(int lhs_, int rhs_) const noexcept
+	{
+		++*calls;
+		return lhs_ < rhs_;
+	}
+};
+
+// McIlroy's adversary, values are fixed lazily so that every pivot turns out as bad as
+//   possible for the comparisons made so far. Sorting indices with it builds a killer input.
+struct Adversary
+{
+	int *    values;
+	int *    solid;
+	int *    candidate;
+	size_t * calls;
+	int      gas;
+
+	inline void freeze(int index_) const noexcept { values[index_] = (*solid)++; }
+
+	inline bool
+	operator()(int lhs_, int rhs_) const noexcept
+	{
+		++*calls;
+		if(values[lhs_] == gas && values[rhs_] == gas)
+			this->freeze(lhs_ == *candidate ? lhs_ : rhs_);
+		if(values[lhs_] == gas)
+			*candidate = lhs_;
+		else if(values[rhs_] == gas)
+			*candidate = rhs_;
+		return values[lhs_] < values[rhs_];
+	}
+};
+
+Test(sort_test)
+{
+	TestInit(sort_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(patterns_branchless)
+	{
+		for(Pattern pattern_ : patterns_)
+		{
+			for(size_t size_ : sizes_)
+			{
+				auto const original_ = make_pattern(pattern_, size_);
+				auto ascending_  = array_t(original_);
+				auto descending_ = array_t(original_);
+				ds::sort(ascending_.begin(), ascending_.end());
+				ds::sort(descending_.begin(), descending_.end(), ds::greater<int>());
+				ExpectTrue(is_sorted(ascending_, ds::less<int>()));
+				ExpectTrue(is_sorted(descending_, ds::greater<int>()));
+				ExpectTrue(is_permutation(ascending_, original_));
+				ExpectTrue(is_permutation(descending_, original_));
+			}
+		}
+	} TestcaseEnd(patterns_branchless);
+
+	// adversarial inputs must not go quadratic, the heap sort fallback bounds the worst case
+	Testcase(patterns_comparisons_bounded)
+	{
+		for(Pattern pattern_ : patterns_)
+		{
+			for(size_t size_ : sizes_)
+			{
+				auto const original_ = make_pattern(pattern_, size_, 7);
+				auto array_  = array_t(original_);
+				size_t calls_ = 0;
+				ds::sort(array_.begin(), array_.end(), CountingLess { &calls_ });
+				ExpectTrue(is_sorted(array_, ds::less<int>()));
+				ExpectTrue(is_permutation(array_, original_));
+				size_t log2_ = 1;
+				for(size_t n = size_; n > 1; n >>= 1)
+					++log2_;
+				ExpectTrue(calls_ <= 3 * size_ * log2_ + 16);
+			}
+		}
+	} TestcaseEnd(patterns_comparisons_bounded);
+
+	// sorted, reversed and constant inputs are recognized in linear time
+	Testcase(linear_on_runs)
+	{
+		size_t const size_ = 100000;
+		for(Pattern pattern_ : { Pattern::sorted, Pattern::reversed, Pattern::all_equal })
+		{
+			auto array_ = make_pattern(pattern_, size_);
+			size_t calls_ = 0;
+			ds::sort(array_.begin(), array_.end(), CountingLess { &calls_ });
+			ExpectTrue(is_sorted(array_, ds::less<int>()));
+			ExpectTrue(calls_ <= 4 * size_);
+		}
+	} TestcaseEnd(linear_on_runs);
+
+	Testcase(mcilroy_adversary)
+	{
+		for(size_t size_ : { size_t(1000), size_t(30000) })
+		{
+			int const gas_ = int(size_);
+			auto values_  = array_t(size_, gas_);
+			auto indices_ = array_t(size_, 0);
+			for(size_t i = 0; i < size_; ++i)
+				indices_[i] = int(i);
+			int    solid_     = 0;
+			int    candidate_ = 0;
+			size_t calls_     = 0;
+			ds::sort(indices_.begin(), indices_.end(), Adversary { values_.begin(), &solid_, &candidate_, &calls_, gas_ });
+			size_t log2_ = 1;
+			for(size_t n = size_; n > 1; n >>= 1)
+				++log2_;
+			ExpectTrue(calls_ <= 4 * size_ * log2_);
+			// the input built by the adversary, gas left over being the largest value
+			for(auto & value_ : values_)
+				if(value_ == gas_)
+					value_ = solid_++;
+			auto const original_ = array_t(values_);
+			calls_ = 0;
+			ds::sort(values_.begin(), values_.end(), CountingLess { &calls_ });
+			ExpectTrue(is_sorted(values_, ds::less<int>()));
+			ExpectTrue(is_permutation(values_, original_));
+			ExpectTrue(calls_ <= 4 * size_ * log2_);
+		}
+	} TestcaseEnd(mcilroy_adversary);
+
+	Testcase(floating_point_and_wide_keys)
+	{
+		uint32_t seed_ = 3;
+		auto doubles_ = ds::Array<double>(size_t(5000), 0.0);
+		auto wide_    = ds::Array<uint64_t>(size_t(5000), uint64_t(0));
+		for(size_t i = 0; i < 5000; ++i)
+		{
+			doubles_[i] = double(int(next_random(seed_) % 2001) - 1000) / 8;
+			wide_[i]    = uint64_t(next_random(seed_)) << 32 | next_random(seed_);
+		}
+		ds::sort(doubles_);
+		ds::sort(wide_, ds::greater<uint64_t>());
+		bool sorted_ = true;
+		for(size_t i = 1; i < 5000; ++i)
+			sorted_ = sorted_ && !(doubles_[i] < doubles_[i - 1]) && !(wide_[i - 1] < wide_[i]);
+		ExpectTrue(sorted_);
+	} TestcaseEnd(floating_point_and_wide_keys);
+
+	Testcase(class_elements)
+	{
+		uint32_t seed_ = 5;
+		auto keyed_ = ds::Array<Keyed>(size_t(3000), Keyed {});
+		for(size_t i = 0; i < 3000; ++i)
+			keyed_[i] = Keyed { int(next_random(seed_) % 50), int(i) };
+		ds::sort(keyed_.begin(), keyed_.end());
+		bool sorted_ = true;
+		for(size_t i = 1; i < 3000; ++i)
+			sorted_ = sorted_ && !(keyed_[i] < keyed_[i - 1]);
+		ExpectTrue(sorted_);
+	} TestcaseEnd(class_elements);
+
+	// elements are moved and swapped, never copied nor leaked
+	Testcase(moves_no_copies)
+	{
+		{
+			uint32_t seed_ = 11;
+			auto counters_ = ds::Array<Counter>(size_t(2000), 0);
+			for(auto & counter_ : counters_)
+				counter_ = Counter(int(next_random(seed_) % 100));
+			Counter::reset();
+			ds::sort(counters_.begin(), counters_.end(), [](Counter const & lhs_, Counter const & rhs_) { return lhs_.value() < rhs_.value(); });
+			ExpectTrue(Counter::no_copies());
+			ExpectEQ(Counter::active(), 0);
+			bool sorted_ = true;
+			for(size_t i = 1; i < counters_.size(); ++i)
+				sorted_ = sorted_ && counters_[i - 1].value() <= counters_[i].value();
+			ExpectTrue(sorted_);
+		}
+	} TestcaseEnd(moves_no_copies);
+
+};
+
+TestRegistry(sort_test)
+{
+	Register(patterns_branchless)
+	Register(patterns_comparisons_bounded)
+	Register(linear_on_runs)
+	Register(mcilroy_adversary)
+	Register(floating_point_and_wide_keys)
+	Register(class_elements)
+	Register(moves_no_copies)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return sort_test().run_all(reporter_t<sort_test>(pptest::normal));
+}
@@ -0,0 +1,229 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/deque>
+#include <ds/array>
+#include "../counter"
+
+template class ds::Deque<int>;
+template class ds::Deque<int,ds::default_allocator,4>;
+
+// small chunks so that every few pushes cross a chunk boundary
+using deque_t = ds::Deque<int,ds::default_allocator,4>;
+
+template <class D, size_t size_>
+static bool
+same_values(D const & deque_, int const (& expected_)[size_])
+{
+	if(deque_.size() != size_)
+		return false;
+	size_t i = 0;
+	for(auto & value_ : deque_)
+		if(i >= size_ || value_ != expected_[i++])
+			return false;
+	return i == size_;
+}
+
+// double-ended model of the deque, the middle of a plain buffer
+struct Model
+{
+	int    values[4096] {};
+	size_t first = 2048;
+	size_t last  = 2048;
+
+	inline size_t size() const noexcept { return last - first; }
+
+	bool
+	same(deque_t const & deque_) const
+	{
+		if(deque_.size() != this->size())
+			return false;
+		for(size_t i = 0; i < this->size(); ++i)
+			if(deque_[i] != values[first + i])
+				return false;
+		return this->size() == 0 || (deque_.first() == values[first] && deque_.last() == values[last - 1]);
+	}
+};
+
+Test(deque_test)
+{
+	TestInit(deque_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(empty_deque)
+	{
+		auto deque_ = deque_t();
+		ExpectTrue(!deque_);
+		ExpectEQ(deque_.size(), 0);
+		ExpectFalse(deque_.remove_first());
+		ExpectFalse(deque_.remove_last());
+		ExpectTrue(deque_.begin() == deque_.end());
+		ExpectThrow(deque_t::index_out_of_bounds const &, deque_.at(0));
+	} TestcaseEnd(empty_deque);
+
+	Testcase(push_both_ends)
+	{
+		auto deque_ = deque_t();
+		for(int i = 0; i < 10; ++i)
+		{
+			AssertNotNull(deque_.insert_last(i));
+			AssertNotNull(deque_.insert_first(-1 - i));
+		}
+		ExpectTrue(same_values(deque_, { -10, -9, -8, -7, -6, -5, -4, -3, -2, -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+		ExpectEQ(deque_.first(), -10);
+		ExpectEQ(deque_.last(), 9);
+		ExpectEQ(deque_.at(10), 0);
+		int expected_ = 9;
+		bool reversed_ = true;
+		for(auto it = deque_.rbegin(); it != deque_.rend(); --it)
+			reversed_ = reversed_ && *it == expected_--;
+		ExpectTrue(reversed_);
+		ExpectEQ(expected_, -11);
+	} TestcaseEnd(push_both_ends);
+
+	// elements never move once pushed, whatever happens at either end
+	Testcase(references_stay_valid)
+	{
+		auto deque_ = deque_t();
+		int * middle_ = deque_.insert_last(42);
+		AssertNotNull(middle_);
+		for(int i = 0; i < 1000; ++i)
+		{
+			AssertNotNull(deque_.insert_first(i));
+			AssertNotNull(deque_.insert_last(i));
+		}
+		ExpectTrue(&deque_[1000] == middle_);
+		ExpectEQ(*middle_, 42);
+		for(int i = 0; i < 999; ++i)
+		{
+			AssertTrue(deque_.remove_first());
+			AssertTrue(deque_.remove_last());
+		}
+		ExpectTrue(&deque_[1] == middle_);
+		ExpectEQ(deque_.size(), 3);
+	} TestcaseEnd(references_stay_valid);
+
+	Testcase(random_operations)
+	{
+		auto     deque_ = deque_t();
+		Model    model_;
+		uint32_t seed_  = 12345;
+		bool     same_  = true;
+		for(int step_ = 0; step_ < 20000; ++step_)
+		{
+			seed_ = seed_ * 1664525u + 1013904223u;
+			int const value_ = int(seed_ >> 8);
+			switch((seed_ >> 28) % 4)
+			{
+			case 0:
+				if(model_.first > 0)
+				{
+					AssertNotNull(deque_.insert_first(value_));
+					model_.values[--model_.first] = value_;
+				}
+				break;
+			case 1:
+				if(model_.last < 4096)
+				{
+					AssertNotNull(deque_.insert_last(value_));
+					model_.values[model_.last++] = value_;
+				}
+				break;
+			case 2:
+				ExpectEQ(deque_.remove_first(), model_.size() > 0);
+				if(model_.size() > 0)
+					++model_.first;
+				break;
+			default:
+				ExpectEQ(deque_.remove_last(), model_.size() > 0);
+				if(model_.size() > 0)
+					--model_.last;
+				break;
+			}
+			if(model_.size() == 0)
+				model_.first = model_.last = 2048;
+			same_ = same_ && model_.same(deque_);
+		}
+		ExpectTrue(same_);
+	} TestcaseEnd(random_operations);
+
+	// a queue-like use reuses cached chunks instead of growing the map forever
+	Testcase(sliding_window)
+	{
+		auto deque_ = deque_t();
+		for(int i = 0; i < 100000; ++i)
+		{
+			AssertNotNull(deque_.insert_last(i));
+			if(i >= 10)
+			{
+				ExpectEQ(deque_.first(), i - 10);
+				AssertTrue(deque_.remove_first());
+			}
+		}
+		ExpectEQ(deque_.size(), 10);
+		ExpectEQ(deque_.first(), 99990);
+		deque_.shrink();
+		ExpectEQ(deque_.last(), 99999);
+	} TestcaseEnd(sliding_window);
+
+	Testcase(copy_move_swap)
+	{
+		auto deque_ = deque_t({ 1, 2, 3, 4, 5, 6 });
+		AssertTrue(bool(deque_.insert_first(0)));
+		auto copy_ = deque_;
+		ExpectTrue(same_values(copy_, { 0, 1, 2, 3, 4, 5, 6 }));
+		auto moved_ = deque_t(ds::move(deque_));
+		ExpectTrue(!deque_);
+		ExpectTrue(same_values(moved_, { 0, 1, 2, 3, 4, 5, 6 }));
+		auto other_ = deque_t({ 9 });
+		other_.swap(moved_);
+		ExpectTrue(same_values(other_, { 0, 1, 2, 3, 4, 5, 6 }));
+		ExpectTrue(same_values(moved_, { 9 }));
+		auto from_array_ = deque_t(ds::Array<int>({ 3, 2, 1 }));
+		ExpectTrue(same_values(from_array_, { 3, 2, 1 }));
+	} TestcaseEnd(copy_move_swap);
+
+	Testcase(non_trivial_elements)
+	{
+		{
+			auto deque_ = ds::Deque<Counter,ds::default_allocator,4>();
+			for(int i = 0; i < 50; ++i)
+			{
+				AssertNotNull(deque_.emplace_last(i));
+				AssertNotNull(deque_.emplace_first(-i));
+			}
+			ExpectTrue(Counter::no_moves());
+			ExpectTrue(Counter::no_copies());
+			ExpectEQ(Counter::active(), 100);
+			for(int i = 0; i < 20; ++i)
+				AssertTrue(deque_.remove_last());
+			ExpectEQ(Counter::active(), 80);
+			ExpectEQ(deque_.last().value(), 29);
+			ExpectEQ(deque_.first().value(), -49);
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(non_trivial_elements);
+
+};
+
+TestRegistry(deque_test)
+{
+	Register(empty_deque)
+	Register(push_both_ends)
+	Register(references_stay_valid)
+	Register(random_operations)
+	Register(sliding_window)
+	Register(copy_move_swap)
+	Register(non_trivial_elements)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return deque_test().run_all(reporter_t<deque_test>(pptest::normal));
+}
@@ -0,0 +1,177 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/intrusive_list>
+
+// linked into two lists at once through its two hooks
+struct Node
+{
+	int value = 0;
+	ds::IntrusiveListHook hook;
+	ds::IntrusiveListHook other_hook;
+
+	Node() = default;
+	Node(int value_) : value { value_ } {}
+
+	bool operator==(int value_) const noexcept { return value == value_; }
+};
+
+using list_t  = ds::IntrusiveList<Node,&Node::hook>;
+using other_t = ds::IntrusiveList<Node,&Node::other_hook>;
+
+template class ds::IntrusiveList<Node,&Node::hook>;
+
+// values of list_ in order, compared with the expected ones
+template <class L, size_t size_>
+static bool
+same_values(L const & list_, int const (& expected_)[size_])
+{
+	if(list_.size() != size_)
+		return false;
+	size_t i = 0;
+	for(auto & node_ : list_)
+		if(i >= size_ || node_.value != expected_[i++])
+			return false;
+	return i == size_;
+}
+
+Test(intrusive_list_test)
+{
+	TestInit(intrusive_list_test);
+
+	Testcase(default_construct_empty)
+	{
+		auto list_ = list_t();
+		ExpectEQ(list_.size(), 0);
+		ExpectTrue(!list_);
+		ExpectTrue(list_.begin() == list_.end());
+		ExpectTrue(list_.rbegin() == list_.rend());
+		ExpectFalse(list_.remove_first());
+		ExpectFalse(list_.remove_last());
+	} TestcaseEnd(default_construct_empty);
+
+	Testcase(insert_and_iterate)
+	{
+		Node nodes_[5] { 0, 1, 2, 3, 4 };
+		auto list_ = list_t();
+		AssertTrue(bool(list_.insert_last(nodes_[2])));
+		AssertTrue(bool(list_.insert_first(nodes_[0])));
+		AssertTrue(bool(list_.insert_after(list_.iterator_to(nodes_[0]), nodes_[1])));
+		AssertTrue(bool(list_.insert_before(list_.end(), nodes_[4])));
+		AssertTrue(bool(list_.insert_before(list_.iterator_to(nodes_[4]), nodes_[3])));
+		ExpectTrue(same_values(list_, { 0, 1, 2, 3, 4 }));
+		int i = 4;
+		for(auto it = list_.rbegin(); it != list_.rend(); --it)
+			ExpectEQ(it->value, i--);
+		ExpectEQ(i, -1);
+		ExpectTrue(&*list_.position_of(3) == &nodes_[3]);
+		ExpectTrue(list_.position_of(7) == list_.end());
+		list_.destroy();
+	} TestcaseEnd(insert_and_iterate);
+
+	Testcase(linked_object_is_refused)
+	{
+		Node node_ { 1 };
+		auto list_  = list_t();
+		auto other_ = list_t();
+		AssertTrue(bool(list_.insert_last(node_)));
+		ExpectTrue(node_.hook.is_linked());
+		ExpectFalse(bool(list_.insert_last(node_)));
+		ExpectFalse(bool(other_.insert_first(node_)));
+		ExpectEQ(list_.size(), 1);
+		ExpectEQ(other_.size(), 0);
+		AssertTrue(list_.remove(node_));
+		ExpectFalse(node_.hook.is_linked());
+		ExpectFalse(list_.remove(node_));
+		AssertTrue(bool(other_.insert_first(node_)));
+		other_.destroy();
+		ExpectFalse(node_.hook.is_linked());
+	} TestcaseEnd(linked_object_is_refused);
+
+	Testcase(one_object_in_two_lists)
+	{
+		Node nodes_[4] { 0, 1, 2, 3 };
+		auto list_  = list_t();
+		auto other_ = other_t();
+		for(auto & node_ : nodes_)
+		{
+			AssertTrue(bool(list_.insert_last(node_)));
+			AssertTrue(bool(other_.insert_first(node_)));
+		}
+		ExpectTrue(same_values(list_, { 0, 1, 2, 3 }));
+		ExpectTrue(same_values(other_, { 3, 2, 1, 0 }));
+		AssertTrue(list_.remove(nodes_[1]));
+		ExpectTrue(same_values(list_, { 0, 2, 3 }));
+		ExpectTrue(same_values(other_, { 3, 2, 1, 0 }));
+		list_.destroy();
+		other_.destroy();
+	} TestcaseEnd(one_object_in_two_lists);
+
+	Testcase(remove_ends_and_positions)
+	{
+		Node nodes_[6] { 0, 1, 2, 3, 4, 5 };
+		auto list_ = list_t();
+		for(auto & node_ : nodes_)
+			AssertTrue(bool(list_.insert_last(node_)));
+		AssertTrue(list_.remove_first());
+		AssertTrue(list_.remove_last());
+		AssertTrue(list_.remove_at(list_.position_of(3)));
+		ExpectFalse(list_.remove_at(list_.end()));
+		ExpectTrue(same_values(list_, { 1, 2, 4 }));
+		ExpectFalse(nodes_[0].hook.is_linked());
+		ExpectFalse(nodes_[3].hook.is_linked());
+		ExpectFalse(nodes_[5].hook.is_linked());
+		list_.destroy();
+	} TestcaseEnd(remove_ends_and_positions);
+
+	Testcase(move_and_swap_keep_links)
+	{
+		Node nodes_[3] { 0, 1, 2 };
+		auto list_ = list_t();
+		for(auto & node_ : nodes_)
+			AssertTrue(bool(list_.insert_last(node_)));
+		auto moved_ = ds::move(list_);
+		ExpectTrue(!list_);
+		ExpectTrue(same_values(moved_, { 0, 1, 2 }));
+		Node extra_ { 9 };
+		AssertTrue(bool(list_.insert_last(extra_)));
+		list_.swap(moved_);
+		ExpectTrue(same_values(list_, { 0, 1, 2 }));
+		ExpectTrue(same_values(moved_, { 9 }));
+		AssertTrue(list_.remove_last());
+		AssertTrue(bool(list_.insert_last(nodes_[2])));
+		ExpectTrue(same_values(list_, { 0, 1, 2 }));
+		list_.destroy();
+		moved_.destroy();
+	} TestcaseEnd(move_and_swap_keep_links);
+
+	Testcase(copy_does_not_copy_membership)
+	{
+		Node node_ { 1 };
+		auto list_ = list_t();
+		AssertTrue(bool(list_.insert_last(node_)));
+		Node copy_ = node_;
+		ExpectFalse(copy_.hook.is_linked());
+		ExpectEQ(copy_.value, 1);
+		list_.destroy();
+	} TestcaseEnd(copy_does_not_copy_membership);
+
+};
+
+TestRegistry(intrusive_list_test)
+{
+	Register(default_construct_empty)
+	Register(insert_and_iterate)
+	Register(linked_object_is_refused)
+	Register(one_object_in_two_lists)
+	Register(remove_ends_and_positions)
+	Register(move_and_swap_keep_links)
+	Register(copy_does_not_copy_membership)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return intrusive_list_test().run_all(reporter_t<intrusive_list_test>(pptest::normal));
+}
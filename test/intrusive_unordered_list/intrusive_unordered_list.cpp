@@ -0,0 +1,151 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/intrusive_unordered_list>
+
+struct Item
+{
+	int key = 0;
+	ds::IntrusiveHashHook hook;
+
+	Item() = default;
+	Item(int key_) : key { key_ } {}
+
+	bool operator==(Item const & rhs) const noexcept { return key == rhs.key; }
+	bool operator==(int key_)         const noexcept { return key == key_; }
+};
+
+namespace ds {
+
+template <>
+struct Hasher<Item>
+{
+	static inline size_t hash(Item const & item) { return Hasher<int>::hash(item.key); }
+	static inline size_t hash(int key) { return Hasher<int>::hash(key); }
+};
+
+} // namespace ds
+
+using table_t = ds::IntrusiveUnorderedList<16,Item,&Item::hook>;
+
+template class ds::IntrusiveUnorderedList<16,Item,&Item::hook>;
+
+Test(intrusive_unordered_list_test)
+{
+	TestInit(intrusive_unordered_list_test);
+
+	Testcase(default_construct_empty)
+	{
+		auto table_ = table_t();
+		ExpectEQ(table_.size(), 0);
+		ExpectTrue(!table_);
+		ExpectTrue(table_.begin() == table_.end());
+		ExpectFalse(table_.contains(1));
+		ExpectEQ(table_t::table_size(), 16);
+	} TestcaseEnd(default_construct_empty);
+
+	Testcase(insert_find_and_iterate)
+	{
+		Item items_[100];
+		auto table_ = table_t();
+		for(int i = 0; i < 100; ++i)
+		{
+			items_[i].key = i;
+			AssertTrue(bool(table_.insert(items_[i])));
+		}
+		AssertEQ(table_.size(), 100);
+		for(int i = 0; i < 100; ++i)
+		{
+			auto it = table_.position_of(i);
+			AssertTrue(bool(it));
+			ExpectTrue(&*it == &items_[i]);
+		}
+		ExpectFalse(table_.contains(100));
+		ExpectTrue(table_.position_of(100) == table_.end());
+		bool seen_[100] {};
+		size_t count_ = 0;
+		for(auto & item_ : table_)
+		{
+			AssertLT(item_.key, 100);
+			ExpectFalse(seen_[item_.key]);
+			seen_[item_.key] = true;
+			++count_;
+		}
+		ExpectEQ(count_, 100);
+		table_.destroy();
+		for(auto & item_ : items_)
+			ExpectFalse(item_.hook.is_linked());
+	} TestcaseEnd(insert_find_and_iterate);
+
+	Testcase(duplicates_and_unique)
+	{
+		Item items_[3] { 7, 7, 7 };
+		auto table_ = table_t();
+		AssertTrue(bool(table_.insert(items_[0])));
+		AssertTrue(bool(table_.insert(items_[1])));
+		ExpectFalse(bool(table_.insert(items_[1])));
+		auto it = table_.insert_unique(items_[2]);
+		AssertTrue(bool(it));
+		ExpectTrue(&*it != &items_[2]);
+		ExpectFalse(items_[2].hook.is_linked());
+		ExpectEQ(table_.size(), 2);
+		ExpectTrue(bool(table_.position_of(7, 1)));
+		ExpectFalse(bool(table_.position_of(7, 2)));
+		table_.destroy();
+	} TestcaseEnd(duplicates_and_unique);
+
+	Testcase(remove_relinks_chain)
+	{
+		Item items_[40];
+		auto table_ = table_t();
+		for(int i = 0; i < 40; ++i)
+		{
+			items_[i].key = i;
+			AssertTrue(bool(table_.insert(items_[i])));
+		}
+		for(int i = 0; i < 40; i += 2)
+			AssertTrue(table_.remove(items_[i]));
+		ExpectFalse(table_.remove(items_[0]));
+		AssertTrue(table_.remove_at(table_.position_of(5)));
+		ExpectFalse(table_.remove_at(table_.end()));
+		ExpectEQ(table_.size(), 19);
+		for(int i = 0; i < 40; ++i)
+			ExpectEQ(table_.contains(i), i % 2 == 1 && i != 5);
+		table_.destroy();
+	} TestcaseEnd(remove_relinks_chain);
+
+	Testcase(move_keeps_links)
+	{
+		Item items_[3] { 1, 2, 3 };
+		auto table_ = table_t();
+		for(auto & item_ : items_)
+			AssertTrue(bool(table_.insert(item_)));
+		auto moved_ = ds::move(table_);
+		ExpectTrue(!table_);
+		ExpectEQ(moved_.size(), 3);
+		ExpectTrue(moved_.contains(2));
+		AssertTrue(moved_.remove(items_[1]));
+		AssertTrue(bool(table_.insert(items_[1])));
+		ExpectTrue(table_.contains(2));
+		ExpectFalse(moved_.contains(2));
+		table_.destroy();
+		moved_.destroy();
+	} TestcaseEnd(move_keeps_links);
+
+};
+
+TestRegistry(intrusive_unordered_list_test)
+{
+	Register(default_construct_empty)
+	Register(insert_find_and_iterate)
+	Register(duplicates_and_unique)
+	Register(remove_relinks_chain)
+	Register(move_keeps_links)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return intrusive_unordered_list_test().run_all(reporter_t<intrusive_unordered_list_test>(pptest::normal));
+}
@@ -0,0 +1,220 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/list>
+#include "../counter"
+#include "../keyed"
+
+template class ds::List<1,int>;
+template class ds::List<2,int>;
+
+using slist_t = ds::List<1,int>;
+using dlist_t = ds::List<2,int>;
+
+// values of list_ in order, compared with the expected ones
+template <class L, size_t size_>
+static bool
+same_values(L const & list_, int const (& expected_)[size_])
+{
+	if(list_.size() != size_)
+		return false;
+	size_t i = 0;
+	for(auto & value_ : list_)
+		if(i >= size_ || value_ != expected_[i++])
+			return false;
+	return i == size_;
+}
+
+// walks the prev links back from the last node, which sort, merge and splice relink
+template <size_t size_>
+static bool
+same_values_reversed(dlist_t const & list_, int const (& expected_)[size_])
+{
+	size_t i = size_;
+	for(auto it = list_.rbegin(); it != list_.rend(); --it)
+		if(i == 0 || *it != expected_[--i])
+			return false;
+	return i == 0;
+}
+
+template <class L>
+static bool
+is_sorted_stable(L const & list_)
+{
+	Keyed const * prev_ = nullptr;
+	for(auto & value_ : list_)
+	{
+		if(prev_ && (value_.key < prev_->key || (value_.key == prev_->key && value_.order < prev_->order)))
+			return false;
+		prev_ = &value_;
+	}
+	return true;
+}
+
+Test(list_test)
+{
+	TestInit(list_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(sort_singly_linked)
+	{
+		auto list_ = slist_t({ 5, 3, 9, 1, 7, 2, 8 });
+		list_.sort();
+		ExpectTrue(same_values(list_, { 1, 2, 3, 5, 7, 8, 9 }));
+		list_.sort(ds::greater<int>());
+		ExpectTrue(same_values(list_, { 9, 8, 7, 5, 3, 2, 1 }));
+		// the last node is found again after relinking
+		AssertTrue(bool(list_.insert_last(0)));
+		ExpectTrue(same_values(list_, { 9, 8, 7, 5, 3, 2, 1, 0 }));
+	} TestcaseEnd(sort_singly_linked);
+
+	Testcase(sort_doubly_linked)
+	{
+		auto list_ = dlist_t({ 5, 3, 9, 1, 7, 2, 8 });
+		list_.sort();
+		ExpectTrue(same_values(list_, { 1, 2, 3, 5, 7, 8, 9 }));
+		ExpectTrue(same_values_reversed(list_, { 1, 2, 3, 5, 7, 8, 9 }));
+		AssertTrue(bool(list_.insert_last(10)));
+		ExpectTrue(same_values_reversed(list_, { 1, 2, 3, 5, 7, 8, 9, 10 }));
+	} TestcaseEnd(sort_doubly_linked);
+
+	Testcase(sort_is_stable)
+	{
+		auto slist_ = ds::List<1,Keyed>();
+		auto dlist_ = ds::List<2,Keyed>();
+		for(int i = 0; i < 1000; ++i)
+		{
+			Keyed const keyed_ { (i * 7919) % 13, i };
+			AssertTrue(bool(slist_.insert_last(keyed_)));
+			AssertTrue(bool(dlist_.insert_last(keyed_)));
+		}
+		slist_.sort();
+		dlist_.sort();
+		ExpectEQ(slist_.size(), 1000);
+		ExpectEQ(dlist_.size(), 1000);
+		ExpectTrue(is_sorted_stable(slist_));
+		ExpectTrue(is_sorted_stable(dlist_));
+	} TestcaseEnd(sort_is_stable);
+
+	Testcase(sort_moves_no_objects)
+	{
+		auto list_ = ds::List<2,Counter>();
+		for(int i = 0; i < 50; ++i)
+			AssertTrue(bool(list_.emplace_last((i * 17) % 50)));
+		Counter::reset();
+		list_.sort();
+		ExpectTrue(Counter::no_moves());
+		ExpectTrue(Counter::no_copies());
+		int i = 0;
+		for(auto & value_ : list_)
+			ExpectEQ(value_.value(), i++);
+	} TestcaseEnd(sort_moves_no_objects);
+
+	Testcase(merge_sorted_lists)
+	{
+		auto slhs_ = slist_t({ 1, 3, 5, 7 });
+		auto srhs_ = slist_t({ 0, 2, 3, 8, 9 });
+		slhs_.merge(srhs_);
+		ExpectTrue(same_values(slhs_, { 0, 1, 2, 3, 3, 5, 7, 8, 9 }));
+		ExpectFalse(bool(srhs_));
+		ExpectEQ(srhs_.size(), 0);
+		AssertTrue(bool(slhs_.insert_last(10)));
+		ExpectTrue(same_values(slhs_, { 0, 1, 2, 3, 3, 5, 7, 8, 9, 10 }));
+		auto dlhs_ = dlist_t({ 4, 6 });
+		dlhs_.merge(dlist_t({ 1, 5, 7 }));
+		ExpectTrue(same_values(dlhs_, { 1, 4, 5, 6, 7 }));
+		ExpectTrue(same_values_reversed(dlhs_, { 1, 4, 5, 6, 7 }));
+		auto empty_ = dlist_t();
+		empty_.merge(dlhs_);
+		ExpectTrue(same_values(empty_, { 1, 4, 5, 6, 7 }));
+		ExpectTrue(!dlhs_);
+	} TestcaseEnd(merge_sorted_lists);
+
+	Testcase(merge_keeps_lhs_first)
+	{
+		auto lhs_ = ds::List<2,Keyed>();
+		auto rhs_ = ds::List<2,Keyed>();
+		for(int i = 0; i < 5; ++i)
+		{
+			AssertTrue(bool(lhs_.insert_last(Keyed { i, 0 })));
+			AssertTrue(bool(rhs_.insert_last(Keyed { i, 1 })));
+		}
+		lhs_.merge(rhs_);
+		ExpectEQ(lhs_.size(), 10);
+		ExpectTrue(is_sorted_stable(lhs_));
+	} TestcaseEnd(merge_keeps_lhs_first);
+
+	Testcase(splice_whole_list)
+	{
+		auto list_  = dlist_t({ 1, 2, 3 });
+		auto other_ = dlist_t({ 7, 8 });
+		AssertTrue(list_.splice(list_.position_of(2), other_));
+		ExpectTrue(same_values(list_, { 1, 7, 8, 2, 3 }));
+		ExpectTrue(same_values_reversed(list_, { 1, 7, 8, 2, 3 }));
+		ExpectTrue(!other_);
+		other_ = dlist_t({ 0 });
+		AssertTrue(list_.splice(list_.begin(), other_));
+		other_ = dlist_t({ 9 });
+		AssertTrue(list_.splice(list_.end(), other_));
+		ExpectTrue(same_values(list_, { 0, 1, 7, 8, 2, 3, 9 }));
+		ExpectTrue(same_values_reversed(list_, { 0, 1, 7, 8, 2, 3, 9 }));
+		ExpectFalse(list_.splice(list_.end(), list_));
+	} TestcaseEnd(splice_whole_list);
+
+	Testcase(splice_one_node)
+	{
+		auto list_  = dlist_t({ 1, 2, 3 });
+		auto other_ = dlist_t({ 7, 8, 9 });
+		AssertTrue(list_.splice(list_.end(), other_, other_.position_of(8)));
+		ExpectTrue(same_values(list_, { 1, 2, 3, 8 }));
+		ExpectTrue(same_values(other_, { 7, 9 }));
+		ExpectTrue(same_values_reversed(other_, { 7, 9 }));
+		AssertTrue(list_.splice(list_.begin(), list_, list_.position_of(3)));
+		ExpectTrue(same_values(list_, { 3, 1, 2, 8 }));
+		ExpectTrue(same_values_reversed(list_, { 3, 1, 2, 8 }));
+		ExpectFalse(list_.splice(list_.end(), other_, list_.begin()));
+	} TestcaseEnd(splice_one_node);
+
+	Testcase(splice_range)
+	{
+		auto list_  = dlist_t({ 1, 2, 3 });
+		auto other_ = dlist_t({ 5, 6, 7, 8, 9 });
+		AssertTrue(list_.splice(list_.position_of(3), other_, other_.position_of(6), other_.position_of(9)));
+		ExpectTrue(same_values(list_, { 1, 2, 6, 7, 8, 3 }));
+		ExpectTrue(same_values(other_, { 5, 9 }));
+		ExpectTrue(same_values_reversed(list_, { 1, 2, 6, 7, 8, 3 }));
+		ExpectTrue(same_values_reversed(other_, { 5, 9 }));
+		AssertTrue(list_.splice(list_.begin(), list_, list_.position_of(7), list_.end()));
+		ExpectTrue(same_values(list_, { 7, 8, 3, 1, 2, 6 }));
+		ExpectTrue(same_values_reversed(list_, { 7, 8, 3, 1, 2, 6 }));
+		AssertTrue(list_.splice(list_.end(), other_, other_.begin(), other_.end()));
+		ExpectTrue(same_values(list_, { 7, 8, 3, 1, 2, 6, 5, 9 }));
+		ExpectTrue(!other_);
+		ExpectEQ(other_.size(), 0);
+	} TestcaseEnd(splice_range);
+
+};
+
+TestRegistry(list_test)
+{
+	Register(sort_singly_linked)
+	Register(sort_doubly_linked)
+	Register(sort_is_stable)
+	Register(sort_moves_no_objects)
+	Register(merge_sorted_lists)
+	Register(merge_keeps_lhs_first)
+	Register(splice_whole_list)
+	Register(splice_one_node)
+	Register(splice_range)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return list_test().run_all(reporter_t<list_test>(pptest::normal));
+}
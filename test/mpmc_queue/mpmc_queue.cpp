@@ -0,0 +1,187 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/mpmc_queue>
+#include <ds/thread>
+#include "../counter"
+
+template class ds::MpmcQueue<int>;
+template class ds::MpmcQueue<Counter>;
+
+using queue_t = ds::MpmcQueue<int>;
+
+static constexpr int producers_    = 4;
+static constexpr int consumers_    = 4;
+static constexpr int per_producer_ = 20000;
+
+Test(mpmc_queue_test)
+{
+	TestInit(mpmc_queue_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(null_queue)
+	{
+		queue_t queue_;
+		int value_ = 0;
+		ExpectTrue(!queue_);
+		ExpectEQ(queue_.capacity(), 0);
+		ExpectFalse(queue_.try_push(1));
+		ExpectFalse(queue_.try_pop(value_));
+		ExpectFalse(queue_.push(1));
+		ExpectFalse(queue_.pop(value_));
+	} TestcaseEnd(null_queue);
+
+	Testcase(try_push_try_pop)
+	{
+		queue_t small_(1);
+		ExpectEQ(small_.capacity(), 2);
+		queue_t queue_(6);
+		ExpectEQ(queue_.capacity(), 8);
+		int value_ = 0;
+		for(int round_ = 0; round_ < 3; ++round_)
+		{
+			for(int i = 0; i < 8; ++i)
+				AssertTrue(queue_.try_push(i));
+			ExpectFalse(queue_.try_push(8));
+			ExpectEQ(queue_.size(), 8);
+			for(int i = 0; i < 8; ++i)
+			{
+				AssertTrue(queue_.try_pop(value_));
+				ExpectEQ(value_, i);
+			}
+			ExpectFalse(queue_.try_pop(value_));
+			ExpectTrue(queue_.empty());
+		}
+	} TestcaseEnd(try_push_try_pop);
+
+	Testcase(close_drains)
+	{
+		queue_t queue_(4);
+		AssertTrue(queue_.push(1));
+		AssertTrue(queue_.push(2));
+		queue_.close();
+		ExpectTrue(queue_.closed());
+		ExpectFalse(queue_.push(3));
+		ExpectFalse(queue_.try_push(3));
+		ExpectEQ(queue_.size(), 2);
+		int value_ = 0;
+		AssertTrue(queue_.pop(value_));
+		ExpectEQ(value_, 1);
+		AssertTrue(queue_.pop(value_));
+		ExpectEQ(value_, 2);
+		ExpectFalse(queue_.pop(value_));
+	} TestcaseEnd(close_drains);
+
+	Testcase(destroy_destructs_queued)
+	{
+		{
+			ds::MpmcQueue<Counter> queue_(8);
+			for(int i = 0; i < 5; ++i)
+				AssertTrue(queue_.try_push(i));
+			Counter popped_ { -1 };
+			AssertTrue(queue_.try_pop(popped_));
+			ExpectEQ(popped_.value(), 0);
+			ExpectEQ(Counter::active(), 5);
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(destroy_destructs_queued);
+
+	Testcase(blocked_threads_woken_by_close)
+	{
+		queue_t empty_(2);
+		queue_t full_(2);
+		AssertTrue(full_.try_push(0));
+		AssertTrue(full_.try_push(1));
+		bool popped_ = true;
+		bool pushed_ = true;
+		{
+			auto consumer_ = ds::Thread([&]() {
+				int value_ = 0;
+				popped_ = empty_.pop(value_);
+			});
+			auto producer_ = ds::Thread([&]() {
+				pushed_ = full_.push(2);
+			});
+			empty_.close();
+			full_.close();
+		}
+		ExpectFalse(popped_);
+		ExpectFalse(pushed_);
+		ExpectEQ(full_.size(), 2);
+	} TestcaseEnd(blocked_threads_woken_by_close);
+
+	// producers and consumers share a small queue so both sides block and park;
+	//   every value is popped exactly once and each producer's values come out
+	//   of any one consumer in push order
+	Testcase(concurrent_producers_consumers)
+	{
+		queue_t queue_(8);
+		auto seen_ = new unsigned char[producers_ * per_producer_] {};
+		bool ordered_[consumers_] {};
+		ds::Thread * producer_threads_[producers_];
+		ds::Thread * consumer_threads_[consumers_];
+		for(int c = 0; c < consumers_; ++c)
+		{
+			consumer_threads_[c] = new ds::Thread([&queue_, &ordered_, seen_, c]() {
+				// half of the consumers park right away
+				queue_t::spin_count = c % 2 == 0 ? 0 : 128;
+				int  last_[producers_];
+				bool ordered = true;
+				for(auto & last : last_)
+					last = -1;
+				int value_ = 0;
+				while(queue_.pop(value_))
+				{
+					int const p = value_ / per_producer_;
+					ordered  = ordered && value_ % per_producer_ > last_[p];
+					last_[p] = value_ % per_producer_;
+					++seen_[value_];
+				}
+				ordered_[c] = ordered;
+			});
+		}
+		for(int p = 0; p < producers_; ++p)
+		{
+			producer_threads_[p] = new ds::Thread([&queue_, p]() {
+				queue_t::spin_count = p % 2 == 0 ? 0 : 128;
+				for(int i = 0; i < per_producer_; ++i)
+					queue_.push(p * per_producer_ + i);
+			});
+		}
+		for(auto thread_ : producer_threads_)
+			delete thread_;
+		queue_.close();
+		for(auto thread_ : consumer_threads_)
+			delete thread_;
+		for(bool ordered : ordered_)
+			ExpectTrue(ordered);
+		bool once_ = true;
+		for(int i = 0; i < producers_ * per_producer_; ++i)
+			once_ = once_ && seen_[i] == 1;
+		ExpectTrue(once_);
+		ExpectTrue(queue_.empty());
+		delete[] seen_;
+	} TestcaseEnd(concurrent_producers_consumers);
+
+};
+
+TestRegistry(mpmc_queue_test)
+{
+	Register(null_queue)
+	Register(try_push_try_pop)
+	Register(close_drains)
+	Register(destroy_destructs_queued)
+	Register(blocked_threads_woken_by_close)
+	Register(concurrent_producers_consumers)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return mpmc_queue_test().run_all(reporter_t<mpmc_queue_test>(pptest::normal));
+}
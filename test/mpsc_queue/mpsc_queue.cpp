@@ -0,0 +1,140 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/mpsc_queue>
+#include <ds/thread>
+
+struct Item
+{
+	int producer = 0;
+	int sequence = 0;
+	ds::MpscQueueHook hook;
+};
+
+using queue_t = ds::MpscQueue<Item,&Item::hook>;
+
+template class ds::MpscQueue<Item,&Item::hook>;
+
+static constexpr int producers_ = 4;
+static constexpr int per_producer_ = 20000;
+
+Test(mpsc_queue_test)
+{
+	TestInit(mpsc_queue_test);
+
+	Testcase(default_construct_empty)
+	{
+		queue_t queue_;
+		ExpectTrue(queue_.empty());
+		ExpectTrue(!queue_);
+		ExpectNull(queue_.pop());
+		ExpectEQ(queue_.pop_all([](Item &) {}), 0);
+	} TestcaseEnd(default_construct_empty);
+
+	Testcase(pop_in_push_order)
+	{
+		queue_t queue_;
+		Item items_[10];
+		for(int i = 0; i < 10; ++i)
+		{
+			items_[i].sequence = i;
+			queue_.push(items_[i]);
+		}
+		ExpectFalse(queue_.empty());
+		for(int i = 0; i < 5; ++i)
+		{
+			Item * item_ = queue_.pop();
+			AssertNotNull(item_);
+			ExpectEQ(item_->sequence, i);
+		}
+		// an object can be pushed again once popped
+		queue_.push(items_[0]);
+		int expected_[] = { 5, 6, 7, 8, 9, 0 };
+		size_t i = 0;
+		ExpectEQ(queue_.pop_all([&](Item & item_) { ExpectEQ(item_.sequence, expected_[i++]); }), 6);
+		ExpectTrue(queue_.empty());
+		ExpectNull(queue_.pop());
+	} TestcaseEnd(pop_in_push_order);
+
+	Testcase(wake_returns_null_once)
+	{
+		queue_t queue_;
+		queue_.wake();
+		ExpectNull(queue_.pop_wait());
+		Item item_;
+		queue_.push(item_);
+		ExpectTrue(queue_.pop_wait() == &item_);
+	} TestcaseEnd(wake_returns_null_once);
+
+	// producers push concurrently while the consumer pops, each producer's
+	//   objects come out in its push order and none is lost or duplicated
+	Testcase(concurrent_producers)
+	{
+		queue_t queue_;
+		auto items_ = new Item[producers_ * per_producer_];
+		ds::Thread * threads_[producers_];
+		for(int p = 0; p < producers_; ++p)
+		{
+			threads_[p] = new ds::Thread([&queue_, items_, p]() {
+				for(int i = 0; i < per_producer_; ++i)
+				{
+					Item & item_ = items_[p * per_producer_ + i];
+					item_.producer = p;
+					item_.sequence = i;
+					queue_.push(item_);
+				}
+			});
+		}
+		int  next_[producers_] {};
+		bool ordered_ = true;
+		for(int popped_ = 0; popped_ < producers_ * per_producer_; ++popped_)
+		{
+			Item * item_ = queue_.pop_wait();
+			AssertNotNull(item_);
+			ordered_ = ordered_ && item_->sequence == next_[item_->producer];
+			next_[item_->producer] = item_->sequence + 1;
+		}
+		for(auto thread_ : threads_)
+			delete thread_;
+		ExpectTrue(ordered_);
+		for(int p = 0; p < producers_; ++p)
+			ExpectEQ(next_[p], per_producer_);
+		ExpectTrue(queue_.empty());
+		delete[] items_;
+	} TestcaseEnd(concurrent_producers);
+
+	Testcase(blocked_consumer_is_woken)
+	{
+		queue_t queue_;
+		Item item_;
+		Item * popped_[2] {};
+		{
+			auto consumer_ = ds::Thread([&]() {
+				popped_[0] = queue_.pop_wait();
+				popped_[1] = queue_.pop_wait();
+			});
+			queue_.push(item_);
+			// kept until the consumer finds the queue empty
+			queue_.wake();
+		}
+		ExpectTrue(popped_[0] == &item_);
+		ExpectNull(popped_[1]);
+	} TestcaseEnd(blocked_consumer_is_woken);
+
+};
+
+TestRegistry(mpsc_queue_test)
+{
+	Register(default_construct_empty)
+	Register(pop_in_push_order)
+	Register(wake_returns_null_once)
+	Register(concurrent_producers)
+	Register(blocked_consumer_is_woken)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return mpsc_queue_test().run_all(reporter_t<mpsc_queue_test>(pptest::normal));
+}
@@ -0,0 +1,200 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/parallel>
+#include <ds/array>
+#include "../random"
+
+using pool_t  = ds::ThreadPool<>;
+using array_t = ds::Array<int>;
+
+// size_ pseudo-random values below range_
+static array_t
+random_array(size_t size_, uint32_t seed_, uint32_t range_)
+{
+	auto array_ = array_t(size_, 0);
+	for(auto & value_ : array_)
+		value_ = int(next_random(seed_) % range_);
+	return array_;
+}
+
+template <class C>
+static bool
+is_sorted(array_t const & array_, C && compare)
+{
+	for(size_t i = 1; i < array_.size(); ++i)
+		if(compare(array_[i], array_[i - 1]))
+			return false;
+	return true;
+}
+
+struct record_t { long a; };
+
+// whether parallel::reduce(records, 0L, op_) is viable
+template <class Op, typename = void>
+struct can_reduce_records : ds::false_type {};
+
+template <class Op>
+struct can_reduce_records<Op, decltype(void(ds::parallel::reduce(ds::decl<ds::Array<record_t> &>(), 0L, ds::decl<Op>())))> : ds::true_type {};
+
+Test(parallel_test)
+{
+	TestInit(parallel_test);
+
+	pool_t pool_ { 4 };
+
+	PreRun()
+	{
+		// small grains so that every test splits its ranges into many tasks
+		ds::parallel::tunables::min_grain = 64;
+	}
+
+	Testcase(for_each_every_element)
+	{
+		auto array_ = array_t(size_t(100000), 0);
+		ds::parallel::for_each(array_, [](int & value_) { ++value_; }, pool_);
+		bool once_ = true;
+		for(int value_ : array_)
+			once_ = once_ && value_ == 1;
+		ExpectTrue(once_);
+		auto empty_ = array_t(size_t(0), 0);
+		ds::parallel::for_each(empty_.begin(), empty_.end(), [](int & value_) { ++value_; }, pool_);
+	} TestcaseEnd(for_each_every_element);
+
+	Testcase(transform_keeps_positions)
+	{
+		auto array_ = array_t(size_t(50001), 0);
+		for(size_t i = 0; i < array_.size(); ++i)
+			array_[i] = int(i);
+		auto out_ = array_t(array_.size(), 0);
+		int * end_ = ds::parallel::transform(array_, out_.begin(), [](int value_) { return value_ * 2; }, pool_);
+		ExpectTrue(end_ == out_.end());
+		bool same_ = true;
+		for(size_t i = 0; i < out_.size(); ++i)
+			same_ = same_ && out_[i] == int(i) * 2;
+		ExpectTrue(same_);
+	} TestcaseEnd(transform_keeps_positions);
+
+	Testcase(reduce_keeps_chunk_order)
+	{
+		auto array_ = array_t(size_t(30000), 0);
+		for(size_t i = 0; i < array_.size(); ++i)
+			array_[i] = int(i);
+		long const sum_ = ds::parallel::reduce(array_, 0L, [](long lhs_, long rhs_) { return lhs_ + rhs_; }, pool_);
+		ExpectEQ(sum_, 30000L * 29999L / 2);
+		// associative but not commutative, the last element wins only if the chunks keep their order
+		int const last_ = ds::parallel::reduce(array_, -1, [](int, int rhs_) { return rhs_; }, pool_);
+		ExpectEQ(last_, 29999);
+		auto empty_ = array_t(size_t(0), 0);
+		ExpectEQ(ds::parallel::reduce(empty_.begin(), empty_.end(), 7, [](int lhs_, int rhs_) { return lhs_ + rhs_; }, pool_), 7);
+	} TestcaseEnd(reduce_keeps_chunk_order);
+
+	// partials are seeded with an element, so a fold that cannot combine two elements
+	//   is rejected up front instead of failing inside reduce
+	Testcase(reduce_rejects_heterogeneous_fold)
+	{
+		auto fold_ = [](long lhs_, record_t const & rhs_) { return lhs_ + rhs_.a; };
+		ExpectFalse(can_reduce_records<decltype(fold_)>::value);
+		auto array_ = ds::Array<record_t>(size_t(30000), record_t { 2 });
+		auto values_ = ds::Array<long>(size_t(30000), 0L);
+		ds::parallel::transform(array_, values_.begin(), [](record_t const & record_) { return record_.a; }, pool_);
+		ExpectEQ(ds::parallel::reduce(values_, 0L, [](long lhs_, long rhs_) { return lhs_ + rhs_; }, pool_), 60000L);
+	} TestcaseEnd(reduce_rejects_heterogeneous_fold);
+
+	Testcase(find_if_first_match)
+	{
+		auto array_ = array_t(size_t(100000), 0);
+		for(size_t i : { size_t(70000), size_t(12345), size_t(99999), size_t(12346) })
+			array_[i] = 1;
+		int * found_ = ds::parallel::find_if(array_, [](int value_) { return value_ == 1; }, pool_);
+		ExpectEQ(size_t(found_ - array_.begin()), 12345);
+		int * none_ = ds::parallel::find_if(array_, [](int value_) { return value_ == 2; }, pool_);
+		ExpectTrue(none_ == array_.end());
+		array_[0] = 2;
+		ExpectTrue(ds::parallel::find_if(array_, [](int value_) { return value_ == 2; }, pool_) == array_.begin());
+	} TestcaseEnd(find_if_first_match);
+
+	Testcase(sort_matches_serial)
+	{
+		for(size_t size_ : { size_t(0), size_t(1), size_t(63), size_t(1000), size_t(65537), size_t(200003) })
+		{
+			for(uint32_t range_ : { 4u, 1000u, 1u << 24 })
+			{
+				auto array_    = random_array(size_, uint32_t(size_) + range_, range_);
+				auto expected_ = array_t(array_);
+				ds::sort(expected_.begin(), expected_.end());
+				ds::parallel::sort(array_, ds::less<int>(), pool_);
+				bool same_ = true;
+				for(size_t i = 0; i < size_; ++i)
+					same_ = same_ && array_[i] == expected_[i];
+				ExpectTrue(same_);
+			}
+		}
+	} TestcaseEnd(sort_matches_serial);
+
+	Testcase(sort_patterns)
+	{
+		size_t const size_ = 100000;
+		auto ascending_  = array_t(size_, 0);
+		auto descending_ = array_t(size_, 0);
+		auto equal_      = array_t(size_, 5);
+		for(size_t i = 0; i < size_; ++i)
+		{
+			ascending_[i]  = int(i);
+			descending_[i] = int(size_ - i);
+		}
+		ds::parallel::sort(ascending_, ds::less<int>(), pool_);
+		ds::parallel::sort(descending_, ds::less<int>(), pool_);
+		ds::parallel::sort(equal_, ds::less<int>(), pool_);
+		ExpectTrue(is_sorted(ascending_, ds::less<int>()));
+		ExpectTrue(is_sorted(descending_, ds::less<int>()));
+		ExpectTrue(is_sorted(equal_, ds::less<int>()));
+		ExpectEQ(descending_[0], 1);
+		ds::parallel::sort(ascending_, ds::greater<int>(), pool_);
+		ExpectTrue(is_sorted(ascending_, ds::greater<int>()));
+	} TestcaseEnd(sort_patterns);
+
+	// elements owning memory are moved through the merge buffer and back
+	Testcase(sort_owning_elements)
+	{
+		using arrays_t = ds::Array<array_t>;
+		uint32_t seed_ = 99;
+		auto arrays_ = arrays_t(size_t(20000), [&seed_]() { return array_t(size_t(3), int(next_random(seed_) % 5000)); });
+		ds::parallel::sort(arrays_, [](array_t const & lhs_, array_t const & rhs_) { return lhs_[0] < rhs_[0]; }, pool_);
+		bool sorted_ = true;
+		for(size_t i = 0; i < arrays_.size(); ++i)
+			sorted_ = sorted_ && arrays_[i].size() == 3 && arrays_[i][0] == arrays_[i][2] && (i == 0 || arrays_[i - 1][0] <= arrays_[i][0]);
+		ExpectTrue(sorted_);
+	} TestcaseEnd(sort_owning_elements);
+
+	Testcase(null_pool_runs_serially)
+	{
+		pool_t null_;
+		auto array_ = random_array(5000, 3, 100);
+		ds::parallel::sort(array_, ds::less<int>(), null_);
+		ExpectTrue(is_sorted(array_, ds::less<int>()));
+		long const sum_ = ds::parallel::reduce(array_, 0L, [](long lhs_, int rhs_) { return lhs_ + rhs_; }, null_);
+		ExpectTrue(sum_ > 0);
+	} TestcaseEnd(null_pool_runs_serially);
+
+};
+
+TestRegistry(parallel_test)
+{
+	Register(for_each_every_element)
+	Register(transform_keeps_positions)
+	Register(reduce_keeps_chunk_order)
+	Register(reduce_rejects_heterogeneous_fold)
+	Register(find_if_first_match)
+	Register(sort_matches_serial)
+	Register(sort_patterns)
+	Register(sort_owning_elements)
+	Register(null_pool_runs_serially)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return parallel_test().run_all(reporter_t<parallel_test>(pptest::normal));
+}
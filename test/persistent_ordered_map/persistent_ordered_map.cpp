@@ -0,0 +1,181 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/persistent_ordered_map>
+#include "../counter"
+
+template class ds::PersistentOrderedMap<int,int>;
+
+using map_t = ds::PersistentOrderedMap<int,int>;
+
+Test(persistent_ordered_map_test)
+{
+	TestInit(persistent_ordered_map_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(default_construct_empty)
+	{
+		auto map_ = map_t();
+		ExpectEQ(map_.size(), 0);
+		ExpectTrue(!map_);
+		ExpectTrue(map_.begin() == map_.end());
+		ExpectNull(map_.get(1));
+		ExpectNull(map_.select(0));
+		ExpectEQ(map_.rank(1), 0);
+		ExpectFalse(map_.remove(1));
+	} TestcaseEnd(default_construct_empty);
+
+	Testcase(set_keeps_order)
+	{
+		auto map_ = map_t();
+		for(int i = 0; i < 100; ++i)
+			AssertTrue(map_.set((i * 37) % 100, i));
+		AssertEQ(map_.size(), 100);
+		int i = 0;
+		for(auto & entry_ : map_)
+		{
+			ExpectEQ(entry_.key, i);
+			ExpectEQ((entry_.value * 37) % 100, i);
+			++i;
+		}
+		ExpectEQ(i, 100);
+	} TestcaseEnd(set_keeps_order);
+
+	Testcase(set_replaces_and_noreplace_keeps)
+	{
+		auto map_ = map_t();
+		AssertTrue(map_.set(1, 10));
+		AssertTrue(map_.set(1, 11));
+		ExpectEQ(map_.size(), 1);
+		ExpectEQ(map_[1], 11);
+		ExpectFalse(map_.set_noreplace(1, 12));
+		ExpectFalse(map_.insert_noreplace(ds::Entry<int,int>(1, 13)));
+		ExpectEQ(map_[1], 11);
+		ExpectTrue(map_.insert_noreplace(ds::Entry<int,int>(2, 20)));
+		AssertNotNull(map_.get(2));
+		ExpectEQ(map_.get(2)->value, 20);
+		ExpectTrue(map_.contains(2));
+		ExpectFalse(map_.contains(3));
+	} TestcaseEnd(set_replaces_and_noreplace_keeps);
+
+	Testcase(snapshot_unchanged_by_updates)
+	{
+		auto map_ = map_t();
+		for(int i = 0; i < 50; ++i)
+			AssertTrue(map_.set(i, i));
+		auto snapshot_ = map_.snapshot();
+		for(int i = 0; i < 50; i += 2)
+			AssertTrue(map_.remove(i));
+		for(int i = 50; i < 80; ++i)
+			AssertTrue(map_.set(i, i));
+		AssertTrue(map_.set(1, -1));
+		ExpectEQ(snapshot_.size(), 50);
+		int i = 0;
+		for(auto & entry_ : snapshot_)
+		{
+			ExpectEQ(entry_.key, i);
+			ExpectEQ(entry_.value, i);
+			++i;
+		}
+		ExpectEQ(map_.size(), 55);
+		ExpectEQ(map_[1], -1);
+		ExpectFalse(map_.contains(0));
+	} TestcaseEnd(snapshot_unchanged_by_updates);
+
+	Testcase(rank_select_and_nearest)
+	{
+		auto map_ = map_t();
+		for(int i = 99; i >= 0; --i)
+			AssertTrue(map_.set(i * 2, i));
+		ExpectEQ(map_.rank(-1), 0);
+		ExpectEQ(map_.rank(0), 0);
+		ExpectEQ(map_.rank(51), 26);
+		ExpectEQ(map_.rank(1000), 100);
+		for(size_t i = 0; i < 100; ++i)
+		{
+			AssertNotNull(map_.select(i));
+			ExpectEQ(map_.select(i)->key, int(i * 2));
+			ExpectEQ(map_.at(i).value, int(i));
+		}
+		ExpectNull(map_.select(100));
+		ExpectThrow(map_t::index_out_of_bounds const &, map_.at(100));
+		AssertNotNull(map_.get_nearest(51));
+		ExpectEQ(map_.get_nearest(51)->key, 52);
+		ExpectEQ(map_.get_nearest(-5)->key, 0);
+		ExpectNull(map_.get_nearest(199));
+	} TestcaseEnd(rank_select_and_nearest);
+
+	Testcase(remove_keeps_balance)
+	{
+		auto map_ = map_t();
+		for(int i = 0; i < 1000; ++i)
+			AssertTrue(map_.set(i, i));
+		for(int i = 0; i < 1000; ++i)
+			if(i % 3 != 0)
+				AssertTrue(map_.remove(i));
+		AssertEQ(map_.size(), 334);
+		for(size_t i = 0; i < map_.size(); ++i)
+			ExpectEQ(map_.at(i).key, int(i * 3));
+		ExpectFalse(map_.remove(1));
+		while(map_.size() > 0)
+			AssertTrue(map_.remove(map_.at(0).key));
+		ExpectTrue(!map_);
+	} TestcaseEnd(remove_keeps_balance);
+
+	Testcase(last_reference_releases_entries)
+	{
+		{
+			auto map_ = ds::PersistentOrderedMap<int,Counter>();
+			for(int i = 0; i < 10; ++i)
+				AssertTrue(map_.set(i, Counter(i)));
+			auto snapshot_ = map_;
+			AssertTrue(map_.remove(5));
+			AssertTrue(map_.set(20, Counter(20)));
+			map_.destroy();
+			ExpectEQ(map_.size(), 0);
+			ExpectEQ(Counter::active(), 10);
+			ExpectEQ(snapshot_[5].value(), 5);
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(last_reference_releases_entries);
+
+	Testcase(move_and_assign)
+	{
+		auto map_ = map_t();
+		for(int i = 0; i < 10; ++i)
+			AssertTrue(map_.set(i, i));
+		auto moved_ = ds::move(map_);
+		ExpectTrue(!map_);
+		ExpectEQ(moved_.size(), 10);
+		map_ = moved_;
+		AssertTrue(moved_.set(10, 10));
+		ExpectEQ(map_.size(), 10);
+		ExpectEQ(moved_.size(), 11);
+		moved_ = ds::move(map_);
+		ExpectEQ(moved_.size(), 10);
+	} TestcaseEnd(move_and_assign);
+
+};
+
+TestRegistry(persistent_ordered_map_test)
+{
+	Register(default_construct_empty)
+	Register(set_keeps_order)
+	Register(set_replaces_and_noreplace_keeps)
+	Register(snapshot_unchanged_by_updates)
+	Register(rank_select_and_nearest)
+	Register(remove_keeps_balance)
+	Register(last_reference_releases_entries)
+	Register(move_and_assign)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return persistent_ordered_map_test().run_all(reporter_t<persistent_ordered_map_test>(pptest::normal));
+}
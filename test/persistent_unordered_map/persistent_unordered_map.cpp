@@ -0,0 +1,170 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/persistent_unordered_map>
+#include "../counter"
+
+template class ds::PersistentUnorderedMap<int,int>;
+
+// every key hashes to one of four values
+struct Colliding
+{
+	int value;
+
+	bool operator==(Colliding const & rhs) const noexcept { return value == rhs.value; }
+	bool operator<(Colliding const & rhs)  const noexcept { return value < rhs.value; }
+};
+
+namespace ds {
+
+template <>
+struct Hasher<Colliding>
+{
+	static inline size_t hash(Colliding const & c) { return size_t(c.value % 4); }
+};
+
+} // namespace ds
+
+Test(persistent_unordered_map_test)
+{
+	TestInit(persistent_unordered_map_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(default_construct_empty)
+	{
+		auto map_ = ds::PersistentUnorderedMap<int,int>();
+		ExpectEQ(map_.size(), 0);
+		ExpectTrue(!map_);
+		ExpectTrue(map_.begin() == map_.end());
+		ExpectNull(map_.get(1));
+		ExpectFalse(map_.remove(1));
+	} TestcaseEnd(default_construct_empty);
+
+	Testcase(set_get_and_iterate)
+	{
+		auto map_ = ds::PersistentUnorderedMap<int,int>();
+		for(int i = 0; i < 5000; ++i)
+			AssertTrue(map_.set(i, i * 2));
+		AssertEQ(map_.size(), 5000);
+		for(int i = 0; i < 5000; ++i)
+		{
+			AssertNotNull(map_.get(i));
+			ExpectEQ(map_[i], i * 2);
+		}
+		ExpectFalse(map_.contains(5000));
+		size_t count_ = 0;
+		long   sum_   = 0;
+		for(auto & entry_ : map_)
+		{
+			++count_;
+			sum_ += entry_.key;
+		}
+		ExpectEQ(count_, 5000);
+		ExpectEQ(sum_, 4999L * 5000 / 2);
+	} TestcaseEnd(set_get_and_iterate);
+
+	Testcase(set_replaces_and_noreplace_keeps)
+	{
+		auto map_ = ds::PersistentUnorderedMap<int,int>();
+		AssertTrue(map_.set(1, 10));
+		AssertTrue(map_.set(1, 11));
+		ExpectEQ(map_.size(), 1);
+		ExpectEQ(map_[1], 11);
+		ExpectFalse(map_.set_noreplace(1, 12));
+		ExpectFalse(map_.insert_noreplace(ds::Entry<int,int>(1, 13)));
+		ExpectTrue(map_.insert_noreplace(ds::Entry<int,int>(2, 20)));
+		ExpectEQ(map_[1], 11);
+		ExpectEQ(map_.size(), 2);
+	} TestcaseEnd(set_replaces_and_noreplace_keeps);
+
+	Testcase(snapshot_unchanged_by_updates)
+	{
+		auto map_ = ds::PersistentUnorderedMap<int,int>();
+		for(int i = 0; i < 1000; ++i)
+			AssertTrue(map_.set(i, i));
+		auto snapshot_ = map_.snapshot();
+		for(int i = 0; i < 1000; i += 2)
+			AssertTrue(map_.remove(i));
+		AssertTrue(map_.set(1, -1));
+		AssertTrue(map_.set(2000, 2000));
+		ExpectEQ(snapshot_.size(), 1000);
+		for(int i = 0; i < 1000; ++i)
+			ExpectEQ(snapshot_[i], i);
+		ExpectFalse(snapshot_.contains(2000));
+		ExpectEQ(map_.size(), 501);
+		ExpectEQ(map_[1], -1);
+		ExpectFalse(map_.contains(0));
+	} TestcaseEnd(snapshot_unchanged_by_updates);
+
+	Testcase(colliding_hashes)
+	{
+		auto map_ = ds::PersistentUnorderedMap<Colliding,int>();
+		for(int i = 0; i < 40; ++i)
+			AssertTrue(map_.set(Colliding { i }, i));
+		AssertEQ(map_.size(), 40);
+		auto snapshot_ = map_;
+		AssertTrue(map_.set(Colliding { 12 }, -12));
+		for(int i = 0; i < 40; i += 3)
+			AssertTrue(map_.remove(Colliding { i }));
+		ExpectFalse(map_.remove(Colliding { 0 }));
+		ExpectEQ(map_.size(), 26);
+		for(int i = 0; i < 40; ++i)
+		{
+			ExpectEQ(map_.contains(Colliding { i }), i % 3 != 0);
+			ExpectEQ(snapshot_[Colliding { i }], i);
+		}
+	} TestcaseEnd(colliding_hashes);
+
+	Testcase(remove_all)
+	{
+		auto map_ = ds::PersistentUnorderedMap<int,int>();
+		for(int i = 0; i < 300; ++i)
+			AssertTrue(map_.set(i, i));
+		for(int i = 0; i < 300; ++i)
+			AssertTrue(map_.remove(i));
+		ExpectEQ(map_.size(), 0);
+		ExpectTrue(map_.begin() == map_.end());
+		AssertTrue(map_.set(7, 7));
+		ExpectEQ(map_[7], 7);
+	} TestcaseEnd(remove_all);
+
+	Testcase(last_reference_releases_entries)
+	{
+		{
+			auto map_ = ds::PersistentUnorderedMap<int,Counter>();
+			for(int i = 0; i < 10; ++i)
+				AssertTrue(map_.set(i, Counter(i)));
+			auto snapshot_ = map_;
+			AssertTrue(map_.remove(5));
+			AssertTrue(map_.set(20, Counter(20)));
+			map_.destroy();
+			ExpectEQ(map_.size(), 0);
+			ExpectEQ(Counter::active(), 10);
+			ExpectEQ(snapshot_[5].value(), 5);
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(last_reference_releases_entries);
+
+};
+
+TestRegistry(persistent_unordered_map_test)
+{
+	Register(default_construct_empty)
+	Register(set_get_and_iterate)
+	Register(set_replaces_and_noreplace_keeps)
+	Register(snapshot_unchanged_by_updates)
+	Register(colliding_hashes)
+	Register(remove_all)
+	Register(last_reference_releases_entries)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return persistent_unordered_map_test().run_all(reporter_t<persistent_unordered_map_test>(pptest::normal));
+}
@@ -0,0 +1,399 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/priority_queue>
+#include <ds/array>
+#include "../counter"
+#include "../random"
+
+using queue_t   = ds::PriorityQueue<int>;
+using indexed_t = ds::IndexedPriorityQueue<int>;
+
+template class ds::PriorityQueue<int>;
+template class ds::IndexedPriorityQueue<int>;
+
+// pushes size_ random values and pops them back, which must come out sorted by compare
+template <size_t arity_, class C>
+static bool
+pops_sorted(size_t size_, uint32_t seed_, C compare_)
+{
+	auto queue_ = ds::PriorityQueue<int,C,arity_>(size_t(0), compare_);
+	for(size_t i = 0; i < size_; ++i)
+		if(!queue_.push(int(next_random(seed_) % (size_ + 1))))
+			return false;
+	if(queue_.size() != size_)
+		return false;
+	int previous_ = 0;
+	for(size_t i = 0; i < size_; ++i)
+	{
+		int value_ = 0;
+		if(!queue_.pop(value_) || (i > 0 && compare_(value_, previous_)))
+			return false;
+		previous_ = value_;
+	}
+	return queue_.size() == 0 && !queue_.pop();
+}
+
+// the model of an indexed queue, alive_[h] telling whether handle h is queued with values_[h]
+struct Model
+{
+	ds::Array<int>  values;
+	ds::Array<bool> alive;
+
+	Model(size_t handles_)
+		: values { handles_, 0 }
+		, alive  { handles_, false }
+	{}
+
+	// smallest value queued, -1 if none
+	int
+	top() const
+	{
+		int top_ = -1;
+		for(size_t i = 0; i < values.size(); ++i)
+			if(alive[i] && (top_ < 0 || values[i] < top_))
+				top_ = values[i];
+		return top_;
+	}
+};
+
+template <size_t arity_>
+static bool
+indexed_matches_model(size_t steps_, uint32_t seed_)
+{
+	size_t const handles_ = 600;
+	auto queue_ = ds::IndexedPriorityQueue<int,ds::less<int>,arity_>(size_t(0));
+	auto model_ = Model(handles_);
+	size_t size_ = 0;
+	for(size_t step_ = 0; step_ < steps_; ++step_)
+	{
+		uint32_t const op_     = next_random(seed_) % 8;
+		size_t const   handle_ = next_random(seed_) % handles_;
+		int const      value_  = int(next_random(seed_) % 100000);
+		bool const     alive_  = model_.alive[handle_];
+		if(queue_.contains(handle_) != alive_)
+			return false;
+		if(op_ <= 2 && size_ < handles_)
+		{
+			size_t const pushed_ = queue_.push(value_);
+			if(pushed_ >= handles_ || model_.alive[pushed_])
+				return false;
+			model_.values[pushed_] = value_;
+			model_.alive[pushed_]  = true;
+			++size_;
+		}
+		else if(op_ == 3 && size_ > 0)
+		{
+			size_t const top_ = queue_.top_handle();
+			if(!model_.alive[top_] || queue_.top() != model_.top() || !queue_.pop())
+				return false;
+			model_.alive[top_] = false;
+			--size_;
+		}
+		else if(op_ == 4)
+		{
+			if(queue_.erase(handle_) != alive_)
+				return false;
+			size_ -= alive_;
+			model_.alive[handle_] = false;
+		}
+		else if(op_ == 5)
+		{
+			int const lower_ = alive_ ? model_.values[handle_] - value_ % 1000 : value_;
+			if(queue_.decrease_key(handle_, lower_) != alive_)
+				return false;
+			if(alive_)
+				model_.values[handle_] = lower_;
+		}
+		else if(op_ == 6)
+		{
+			int const higher_ = alive_ ? model_.values[handle_] + value_ % 1000 : value_;
+			if(queue_.increase_key(handle_, higher_) != alive_)
+				return false;
+			if(alive_)
+				model_.values[handle_] = higher_;
+		}
+		else if(op_ == 7)
+		{
+			if(queue_.update(handle_, value_) != alive_)
+				return false;
+			if(alive_)
+				model_.values[handle_] = value_;
+		}
+		if(queue_.size() != size_ || (size_ > 0 && queue_.top() != model_.top()))
+			return false;
+		if(alive_ && model_.alive[handle_] && queue_[handle_] != model_.values[handle_])
+			return false;
+	}
+	// draining gives every handle back in order
+	int previous_ = ds::min_limit<int>::value;
+	while(size_ > 0)
+	{
+		size_t const top_ = queue_.top_handle();
+		if(!model_.alive[top_] || queue_.top() != model_.values[top_] || queue_.top() < previous_)
+			return false;
+		previous_ = queue_.top();
+		model_.alive[top_] = false;
+		queue_.pop();
+		--size_;
+	}
+	return queue_.size() == 0 && queue_.top_handle() == indexed_t::npos;
+}
+
+Test(priority_queue_test)
+{
+	TestInit(priority_queue_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(null_queue)
+	{
+		queue_t queue_;
+		ExpectTrue(!queue_);
+		ExpectEQ(queue_.size(), 0);
+		ExpectFalse(queue_.pop());
+		int value_ = 7;
+		ExpectFalse(queue_.pop(value_));
+		ExpectEQ(value_, 7);
+		AssertTrue(queue_.push(3));
+		ExpectTrue(bool(queue_));
+		ExpectEQ(queue_.top(), 3);
+		indexed_t indexed_;
+		ExpectTrue(!indexed_);
+		ExpectFalse(indexed_.pop());
+		ExpectFalse(indexed_.erase(0));
+		ExpectFalse(indexed_.contains(0));
+		ExpectEQ(indexed_.top_handle(), indexed_t::npos);
+		ExpectThrow(indexed_t::invalid_handle const &, indexed_.at(0));
+		ExpectEQ(indexed_.push(5), 0);
+		ExpectEQ(indexed_.top(), 5);
+	} TestcaseEnd(null_queue);
+
+	Testcase(pops_sorted_every_arity)
+	{
+		for(size_t size_ : { size_t(0), size_t(1), size_t(2), size_t(5), size_t(17), size_t(1000), size_t(20000) })
+		{
+			uint32_t const seed_ = uint32_t(size_) + 1;
+			ExpectTrue(pops_sorted<2>(size_, seed_, ds::less<int>()));
+			ExpectTrue(pops_sorted<3>(size_, seed_, ds::less<int>()));
+			ExpectTrue(pops_sorted<4>(size_, seed_, ds::less<int>()));
+			ExpectTrue(pops_sorted<8>(size_, seed_, ds::less<int>()));
+			ExpectTrue(pops_sorted<4>(size_, seed_, ds::greater<int>()));
+		}
+	} TestcaseEnd(pops_sorted_every_arity);
+
+	// a stack taken over is ordered in place
+	Testcase(heapify_stack)
+	{
+		uint32_t seed_ = 5;
+		auto stack_ = ds::Stack<int>(size_t(3000));
+		for(int i = 0; i < 3000; ++i)
+			stack_.push(int(next_random(seed_) % 500));
+		auto queue_ = queue_t(ds::move(stack_));
+		ExpectEQ(queue_.size(), 3000);
+		// every element compares no earlier than its parent
+		bool heap_ = true;
+		int const * data_ = queue_.begin();
+		for(size_t i = 1; i < queue_.size(); ++i)
+			heap_ = heap_ && !(data_[i] < data_[(i - 1) / 4]);
+		ExpectTrue(heap_);
+		int previous_ = -1;
+		bool sorted_ = true;
+		for(int value_ = 0; queue_.pop(value_);)
+		{
+			sorted_ = sorted_ && previous_ <= value_;
+			previous_ = value_;
+		}
+		ExpectTrue(sorted_);
+	} TestcaseEnd(heapify_stack);
+
+	Testcase(copy_move_swap)
+	{
+		auto queue_ = queue_t(size_t(0));
+		for(int value_ : { 5, 1, 4, 2, 3 })
+			AssertTrue(queue_.push(value_));
+		auto copy_ = queue_t(queue_);
+		ExpectEQ(copy_.size(), 5);
+		ExpectEQ(copy_.top(), 1);
+		copy_.pop();
+		ExpectEQ(queue_.top(), 1);
+		auto moved_ = queue_t(ds::move(queue_));
+		ExpectTrue(!queue_);
+		ExpectEQ(moved_.size(), 5);
+		moved_.swap(copy_);
+		ExpectEQ(moved_.top(), 2);
+		ExpectEQ(copy_.top(), 1);
+		copy_.clear();
+		ExpectTrue(bool(copy_));
+		ExpectEQ(copy_.size(), 0);
+		moved_.destroy();
+		ExpectTrue(!moved_);
+		ExpectEQ(moved_.size(), 0);
+		ExpectFalse(moved_.pop());
+		AssertTrue(moved_.push(9));
+		ExpectEQ(moved_.top(), 9);
+	} TestcaseEnd(copy_move_swap);
+
+	Testcase(non_trivial_elements)
+	{
+		{
+			auto less_ = [](Counter const & lhs_, Counter const & rhs_) { return lhs_.value() < rhs_.value(); };
+			auto queue_ = ds::PriorityQueue<Counter,decltype(less_)>(size_t(0), less_);
+			uint32_t seed_ = 3;
+			for(int i = 0; i < 1000; ++i)
+				AssertTrue(queue_.push(int(next_random(seed_) % 100)));
+			ExpectEQ(Counter::active(), 1000);
+			Counter counter_;
+			for(int i = 0; i < 400; ++i)
+				AssertTrue(queue_.pop(counter_));
+			ExpectEQ(Counter::active(), 601);
+			ExpectTrue(Counter::no_copies());
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(non_trivial_elements);
+
+	Testcase(indexed_random_operations)
+	{
+		ExpectTrue(indexed_matches_model<2>(30000, 1));
+		ExpectTrue(indexed_matches_model<4>(30000, 2));
+		ExpectTrue(indexed_matches_model<5>(30000, 3));
+	} TestcaseEnd(indexed_random_operations);
+
+	Testcase(indexed_handles_reused)
+	{
+		auto queue_ = indexed_t(size_t(0));
+		size_t const a_ = queue_.push(10);
+		size_t const b_ = queue_.push(20);
+		size_t const c_ = queue_.push(30);
+		ExpectEQ(a_, 0);
+		ExpectEQ(b_, 1);
+		ExpectEQ(c_, 2);
+		AssertTrue(queue_.erase(b_));
+		ExpectFalse(queue_.contains(b_));
+		ExpectFalse(queue_.erase(b_));
+		ExpectThrow(indexed_t::invalid_handle const &, queue_.at(b_));
+		// a freed handle is handed out again
+		ExpectEQ(queue_.push(5), b_);
+		ExpectEQ(queue_.top_handle(), b_);
+		AssertTrue(queue_.decrease_key(c_, 1));
+		ExpectEQ(queue_.top_handle(), c_);
+		AssertTrue(queue_.increase_key(c_, 40));
+		ExpectEQ(queue_.top_handle(), b_);
+		ExpectEQ(queue_.at(c_), 40);
+		queue_.clear();
+		ExpectEQ(queue_.size(), 0);
+		ExpectFalse(queue_.contains(a_));
+		ExpectEQ(queue_.push(1), 0);
+		queue_.destroy();
+		ExpectTrue(!queue_);
+		ExpectEQ(queue_.size(), 0);
+		ExpectFalse(queue_.contains(0));
+		ExpectFalse(queue_.erase(0));
+		ExpectEQ(queue_.top_handle(), indexed_t::npos);
+		ExpectEQ(queue_.push(2), 0);
+	} TestcaseEnd(indexed_handles_reused);
+
+	// shortest paths on a grid with random weights, against relaxing every edge until nothing changes
+	Testcase(indexed_dijkstra)
+	{
+		size_t const side_  = 40;
+		size_t const nodes_ = side_ * side_;
+		uint32_t seed_ = 13;
+		auto weights_ = ds::Array<int>(nodes_, 0);
+		for(auto & weight_ : weights_)
+			weight_ = int(next_random(seed_) % 9) + 1;
+		auto neighbours_ = [side_](size_t node_, size_t (& out_)[4]) {
+			size_t count_ = 0;
+			size_t const x_ = node_ % side_;
+			size_t const y_ = node_ / side_;
+			if(x_ > 0)         out_[count_++] = node_ - 1;
+			if(x_ + 1 < side_) out_[count_++] = node_ + 1;
+			if(y_ > 0)         out_[count_++] = node_ - side_;
+			if(y_ + 1 < side_) out_[count_++] = node_ + side_;
+			return count_;
+		};
+		int const infinity_ = ds::max_limit<int>::value;
+		auto expected_ = ds::Array<int>(nodes_, infinity_);
+		expected_[0] = 0;
+		for(bool changed_ = true; changed_;)
+		{
+			changed_ = false;
+			for(size_t node_ = 0; node_ < nodes_; ++node_)
+			{
+				if(expected_[node_] == infinity_)
+					continue;
+				size_t out_[4];
+				for(size_t i = 0, n = neighbours_(node_, out_); i < n; ++i)
+				{
+					if(expected_[node_] + weights_[out_[i]] < expected_[out_[i]])
+					{
+						expected_[out_[i]] = expected_[node_] + weights_[out_[i]];
+						changed_ = true;
+					}
+				}
+			}
+		}
+		// every node pushed up front, so that handles are node indices
+		auto queue_ = indexed_t(nodes_);
+		for(size_t node_ = 0; node_ < nodes_; ++node_)
+			AssertEQ(queue_.push(node_ == 0 ? 0 : infinity_), node_);
+		auto distances_ = ds::Array<int>(nodes_, infinity_);
+		while(queue_.size() > 0)
+		{
+			size_t const node_ = queue_.top_handle();
+			int const distance_ = queue_.top();
+			distances_[node_] = distance_;
+			queue_.pop();
+			size_t out_[4];
+			for(size_t i = 0, n = neighbours_(node_, out_); i < n; ++i)
+				if(queue_.contains(out_[i]) && distance_ + weights_[out_[i]] < queue_[out_[i]])
+					queue_.decrease_key(out_[i], distance_ + weights_[out_[i]]);
+		}
+		bool same_ = true;
+		for(size_t node_ = 0; node_ < nodes_; ++node_)
+			same_ = same_ && distances_[node_] == expected_[node_];
+		ExpectTrue(same_);
+	} TestcaseEnd(indexed_dijkstra);
+
+	Testcase(indexed_non_trivial_elements)
+	{
+		{
+			auto less_ = [](Counter const & lhs_, Counter const & rhs_) { return lhs_.value() < rhs_.value(); };
+			auto queue_ = ds::IndexedPriorityQueue<Counter,decltype(less_)>(size_t(0), less_);
+			for(int i = 0; i < 500; ++i)
+				AssertEQ(queue_.push(Counter(500 - i)), size_t(i));
+			ExpectEQ(Counter::active(), 500);
+			for(size_t handle_ = 0; handle_ < 500; handle_ += 2)
+				AssertTrue(queue_.erase(handle_));
+			ExpectEQ(Counter::active(), 250);
+			AssertTrue(queue_.update(1, Counter(0)));
+			ExpectEQ(queue_.top_handle(), 1);
+			ExpectTrue(Counter::no_copies());
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(indexed_non_trivial_elements);
+
+};
+
+TestRegistry(priority_queue_test)
+{
+	Register(null_queue)
+	Register(pops_sorted_every_arity)
+	Register(heapify_stack)
+	Register(copy_move_swap)
+	Register(non_trivial_elements)
+	Register(indexed_random_operations)
+	Register(indexed_handles_reused)
+	Register(indexed_dijkstra)
+	Register(indexed_non_trivial_elements)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return priority_queue_test().run_all(reporter_t<priority_queue_test>(pptest::normal));
+}
@@ -0,0 +1,116 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/queue>
+#include <ds/array>
+#include "../counter"
+
+template class ds::Queue<int>;
+template class ds::Queue<int,ds::allocators::NTMalloc>;
+
+// pops the first pop_ pushed values, then pushes until size_ values are held, so that
+//   the held values wrap around the end of the buffer before it grows
+template <class Q>
+static bool
+wrapped_growth_keeps_order(Q & queue_, int pop_, int size_)
+{
+	int next_ = 0;
+	for(; next_ < int(queue_.capacity()); ++next_)
+		if(!queue_.push(next_))
+			return false;
+	for(int i = 0; i < pop_; ++i)
+		if(!queue_.pop())
+			return false;
+	for(; next_ < pop_ + size_; ++next_)
+		if(!queue_.push(next_))
+			return false;
+	if(queue_.size() != size_t(size_))
+		return false;
+	for(int i = 0; i < size_; ++i)
+		if(queue_[size_t(i)] != pop_ + i)
+			return false;
+	for(int i = pop_; i < pop_ + size_; ++i)
+	{
+		if(queue_.bottom() != i)
+			return false;
+		queue_.pop();
+	}
+	return queue_.size() == 0;
+}
+
+Test(queue_test)
+{
+	TestInit(queue_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(push_grows_default_allocator)
+	{
+		auto queue_ = ds::Queue<int>(16);
+		ExpectTrue(wrapped_growth_keeps_order(queue_, 10, 1000));
+	} TestcaseEnd(push_grows_default_allocator);
+
+	Testcase(wrapped_head_moved_on_reallocate)
+	{
+		for(int pop_ : { 0, 1, 8, 15 })
+		{
+			auto queue_ = ds::Queue<int,ds::allocators::NTMalloc>(16);
+			ExpectTrue(wrapped_growth_keeps_order(queue_, pop_, 17));
+			auto large_ = ds::Queue<int,ds::allocators::NTMalloc>(16);
+			ExpectTrue(wrapped_growth_keeps_order(large_, pop_, 5000));
+		}
+	} TestcaseEnd(wrapped_head_moved_on_reallocate);
+
+	Testcase(relocatable_owning_elements)
+	{
+		auto queue_ = ds::Queue<ds::Array<int>,ds::allocators::NTMalloc>(16);
+		for(int i = 0; i < 16; ++i)
+			AssertNotNull(queue_.push(ds::Array<int>(size_t(i % 5 + 1), i)));
+		for(int i = 0; i < 10; ++i)
+			AssertTrue(queue_.pop());
+		for(int i = 16; i < 200; ++i)
+			AssertNotNull(queue_.push(ds::Array<int>(size_t(i % 5 + 1), i)));
+		AssertEQ(queue_.size(), 190);
+		for(size_t i = 0; i < 190; ++i)
+		{
+			ExpectEQ(queue_[i].size(), (i + 10) % 5 + 1);
+			ExpectEQ(queue_[i][0], int(i + 10));
+		}
+	} TestcaseEnd(relocatable_owning_elements);
+
+	Testcase(non_relocatable_elements_are_moved)
+	{
+		{
+			auto queue_ = ds::Queue<Counter,ds::allocators::NTMalloc>(16);
+			for(int i = 0; i < 16; ++i)
+				AssertNotNull(queue_.push(i));
+			for(int i = 0; i < 6; ++i)
+				AssertTrue(queue_.pop());
+			for(int i = 16; i < 100; ++i)
+				AssertNotNull(queue_.push(i));
+			ExpectEQ(Counter::active(), 94);
+			for(size_t i = 0; i < 94; ++i)
+				ExpectEQ(queue_[i].value(), int(i + 6));
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(non_relocatable_elements_are_moved);
+
+};
+
+TestRegistry(queue_test)
+{
+	Register(push_grows_default_allocator)
+	Register(wrapped_head_moved_on_reallocate)
+	Register(relocatable_owning_elements)
+	Register(non_relocatable_elements_are_moved)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return queue_test().run_all(reporter_t<queue_test>(pptest::normal));
+}
@@ -0,0 +1,226 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/radix_sort>
+#include <ds/array>
+#include <ds/string>
+#include "../random"
+#include "../keyed"
+
+// sizes around the insertion sort threshold, and past the one where the most significant byte goes first
+static size_t const sizes_[] { 0, 1, 2, 64, 65, 1000, 65536, 65537, 200000 };
+
+static uint64_t
+next_random64(uint32_t & seed_) noexcept
+{
+	uint64_t const high_ = next_random(seed_);
+	return high_ << 40 ^ uint64_t(next_random(seed_)) << 16 ^ next_random(seed_);
+}
+
+// radix sorted against ds::sort, which must give the very same keys
+template <typename T>
+static bool
+same_as_sort(uint32_t seed_, size_t size_, uint64_t mask_)
+{
+	auto array_ = ds::Array<T>(size_, T(0));
+	for(auto & value_ : array_)
+		value_ = T(next_random64(seed_) & mask_);
+	auto expected_ = ds::Array<T>(array_);
+	ds::sort(expected_.begin(), expected_.end());
+	ds::radix_sort(array_.begin(), array_.end());
+	for(size_t i = 0; i < size_; ++i)
+		if(array_[i] != expected_[i])
+			return false;
+	return true;
+}
+
+static double
+from_bits(uint64_t bits_) noexcept
+{
+	double value_;
+	memcpy(&value_, &bits_, sizeof(value_));
+	return value_;
+}
+
+static bool
+sign_bit(double value_) noexcept
+{
+	uint64_t bits_;
+	memcpy(&bits_, &value_, sizeof(bits_));
+	return (bits_ >> 63) != 0;
+}
+
+struct Named
+{
+	ds::String<> name;
+	int          order = 0;
+};
+
+struct NullAllocator
+{
+	static inline void * allocate(size_t, size_t = alignof(max_align_t)) noexcept { return nullptr; }
+	static inline void   deallocate(void *) noexcept {}
+};
+
+Test(radix_sort_test)
+{
+	TestInit(radix_sort_test);
+
+	Testcase(integral_keys)
+	{
+		for(size_t size_ : sizes_)
+		{
+			uint32_t const seed_ = uint32_t(size_) + 1;
+			ExpectTrue(same_as_sort<int8_t>(seed_, size_, ~uint64_t(0)));
+			ExpectTrue(same_as_sort<uint16_t>(seed_, size_, ~uint64_t(0)));
+			ExpectTrue(same_as_sort<int32_t>(seed_, size_, ~uint64_t(0)));
+			ExpectTrue(same_as_sort<uint32_t>(seed_, size_, ~uint64_t(0)));
+			ExpectTrue(same_as_sort<int64_t>(seed_, size_, ~uint64_t(0)));
+			ExpectTrue(same_as_sort<uint64_t>(seed_, size_, ~uint64_t(0)));
+			// high bytes all equal, their passes are skipped
+			ExpectTrue(same_as_sort<int64_t>(seed_, size_, 0xFFFF));
+			ExpectTrue(same_as_sort<uint32_t>(seed_, size_, 0xFF00));
+		}
+	} TestcaseEnd(integral_keys);
+
+	Testcase(signed_extremes)
+	{
+		auto array_ = ds::Array<int>({ 0, -1, ds::max_limit<int>::value, ds::min_limit<int>::value, 1, -2 });
+		ds::radix_sort(array_);
+		ExpectEQ(array_[0], ds::min_limit<int>::value);
+		ExpectEQ(array_[1], -2);
+		ExpectEQ(array_[2], -1);
+		ExpectEQ(array_[3], 0);
+		ExpectEQ(array_[5], ds::max_limit<int>::value);
+	} TestcaseEnd(signed_extremes);
+
+	Testcase(floating_point_keys)
+	{
+		for(size_t size_ : sizes_)
+		{
+			uint32_t seed_ = uint32_t(size_) + 3;
+			auto doubles_ = ds::Array<double>(size_, 0.0);
+			auto floats_  = ds::Array<float>(size_, 0.f);
+			for(size_t i = 0; i < size_; ++i)
+			{
+				doubles_[i] = (double(next_random(seed_)) - double(1 << 23)) / 1024;
+				floats_[i]  = (float(next_random(seed_) % 20000) - 10000.f) * 1e-3f;
+			}
+			ds::radix_sort(doubles_);
+			ds::radix_sort(floats_);
+			bool sorted_ = true;
+			for(size_t i = 1; i < size_; ++i)
+				sorted_ = sorted_ && !(doubles_[i] < doubles_[i - 1]) && !(floats_[i] < floats_[i - 1]);
+			ExpectTrue(sorted_);
+		}
+	} TestcaseEnd(floating_point_keys);
+
+	// negative NaNs go first, positive ones last, and -0.0 before 0.0
+	Testcase(floating_point_specials)
+	{
+		double const inf_ = 1.0 / 0.0;
+		double const positive_nan_ = from_bits(0x7FF8000000000000ull);
+		double const negative_nan_ = from_bits(0xFFF8000000000000ull);
+		auto array_ = ds::Array<double>({ 1.0, positive_nan_, -0.0, inf_, 0.0, -inf_, negative_nan_, -1.0, 0.0, -0.0 });
+		ds::radix_sort(array_);
+		ExpectTrue(array_[0] != array_[0] && sign_bit(array_[0]));
+		ExpectEQ(array_[1], -inf_);
+		ExpectEQ(array_[2], -1.0);
+		ExpectTrue(array_[3] == 0.0 && sign_bit(array_[3]));
+		ExpectTrue(array_[4] == 0.0 && sign_bit(array_[4]));
+		ExpectTrue(array_[5] == 0.0 && !sign_bit(array_[5]));
+		ExpectTrue(array_[6] == 0.0 && !sign_bit(array_[6]));
+		ExpectEQ(array_[7], 1.0);
+		ExpectEQ(array_[8], inf_);
+		ExpectTrue(array_[9] != array_[9] && !sign_bit(array_[9]));
+	} TestcaseEnd(floating_point_specials);
+
+	Testcase(stable_by_key)
+	{
+		for(size_t size_ : sizes_)
+		{
+			uint32_t seed_ = uint32_t(size_) + 5;
+			auto keyed_ = ds::Array<Keyed>(size_, Keyed {});
+			for(size_t i = 0; i < size_; ++i)
+				keyed_[i] = Keyed { int(next_random(seed_) % 1000) - 500, int(i) };
+			ds::radix_sort(keyed_, [](Keyed const & keyed) { return keyed.key; });
+			bool stable_ = true;
+			for(size_t i = 1; i < size_; ++i)
+				stable_ = stable_ && (keyed_[i - 1].key < keyed_[i].key
+					|| (keyed_[i - 1].key == keyed_[i].key && keyed_[i - 1].order < keyed_[i].order));
+			ExpectTrue(stable_);
+		}
+	} TestcaseEnd(stable_by_key);
+
+	// shared prefixes, empty strings, prefixes of one another and chars past 0x7F
+	Testcase(string_keys)
+	{
+		char const * const words_[] { "", "a", "ab", "abc", "abd", "b", "ba", "\x7F", "\x80", "\xFF", "zz", "abc\xE9", "prefix", "prefixed" };
+		for(size_t size_ : { size_t(14), size_t(100), size_t(5000) })
+		{
+			uint32_t seed_ = uint32_t(size_);
+			auto named_ = ds::Array<Named>(size_, [] { return Named {}; });
+			for(size_t i = 0; i < size_; ++i)
+			{
+				named_[i].name  = ds::String<>(words_[next_random(seed_) % 14]);
+				named_[i].name += ds::String<>(words_[next_random(seed_) % 14]);
+				named_[i].order = int(i);
+			}
+			ds::radix_sort(named_, [](Named const & named) -> ds::String<> const & { return named.name; });
+			bool stable_ = true;
+			for(size_t i = 1; i < size_; ++i)
+			{
+				auto const & lhs_ = named_[i - 1].name;
+				auto const & rhs_ = named_[i].name;
+				int const compare_ = ds::string_compare(lhs_.begin(), rhs_.begin(), lhs_.size(), rhs_.size());
+				stable_ = stable_ && (compare_ < 0 || (compare_ == 0 && named_[i - 1].order < named_[i].order));
+			}
+			ExpectTrue(stable_);
+		}
+	} TestcaseEnd(string_keys);
+
+	// owning elements are moved through the scratch buffer
+	Testcase(owning_elements)
+	{
+		uint32_t seed_ = 17;
+		auto arrays_ = ds::Array<ds::Array<int>>(size_t(70000), [&seed_]() { return ds::Array<int>(size_t(2), int(next_random(seed_))); });
+		ds::radix_sort(arrays_, [](ds::Array<int> const & array_) { return array_[0]; });
+		bool sorted_ = true;
+		for(size_t i = 1; i < arrays_.size(); ++i)
+			sorted_ = sorted_ && arrays_[i - 1][0] <= arrays_[i][0] && arrays_[i][1] == arrays_[i][0];
+		ExpectTrue(sorted_);
+	} TestcaseEnd(owning_elements);
+
+	Testcase(no_buffer_falls_back)
+	{
+		uint32_t seed_ = 23;
+		auto array_ = ds::Array<int>(size_t(1000), 0);
+		for(auto & value_ : array_)
+			value_ = int(next_random(seed_));
+		ds::radix_sort<NullAllocator>(array_.begin(), array_.end());
+		bool sorted_ = true;
+		for(size_t i = 1; i < array_.size(); ++i)
+			sorted_ = sorted_ && array_[i - 1] <= array_[i];
+		ExpectTrue(sorted_);
+	} TestcaseEnd(no_buffer_falls_back);
+
+};
+
+TestRegistry(radix_sort_test)
+{
+	Register(integral_keys)
+	Register(signed_extremes)
+	Register(floating_point_keys)
+	Register(floating_point_specials)
+	Register(stable_by_key)
+	Register(string_keys)
+	Register(owning_elements)
+	Register(no_buffer_falls_back)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return radix_sort_test().run_all(reporter_t<radix_sort_test>(pptest::normal));
+}
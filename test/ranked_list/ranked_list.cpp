@@ -0,0 +1,177 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/ranked_list>
+#include "../counter"
+
+template class ds::RankedList<int>;
+
+Test(ranked_list_test)
+{
+	TestInit(ranked_list_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(default_construct_throws_none)
+	{
+		ExpectThrowNone(ds::RankedList<int>());
+	} TestcaseEnd(default_construct_throws_none);
+
+	Testcase(default_construct_empty)
+	{
+		auto ranked_list = ds::RankedList<int>();
+		ExpectEQ(ranked_list.size(), 0);
+		ExpectTrue(!ranked_list);
+		ExpectTrue(ranked_list.begin() == ranked_list.end());
+		ExpectTrue(ranked_list.select(0) == ranked_list.end());
+		ExpectEQ(ranked_list.rank(10), 0);
+	} TestcaseEnd(default_construct_empty);
+
+	Testcase(insert_keeps_order)
+	{
+		auto ranked_list = ds::RankedList<int>();
+		for(int i = 0; i < 100; ++i)
+			AssertTrue(bool(ranked_list.insert((i * 37) % 100)));
+		AssertEQ(ranked_list.size(), 100);
+		int i = 0;
+		for(auto & value : ranked_list)
+			ExpectEQ(value, i++);
+		ExpectEQ(i, 100);
+	} TestcaseEnd(insert_keeps_order);
+
+	Testcase(insert_unique_and_replace)
+	{
+		auto ranked_list = ds::RankedList<int>();
+		for(int i = 0; i < 50; ++i)
+			AssertTrue(bool(ranked_list.insert_unique(i % 10)));
+		ExpectEQ(ranked_list.size(), 10);
+		for(int i = 0; i < 50; ++i)
+			AssertTrue(bool(ranked_list.insert_replace(i % 5)));
+		ExpectEQ(ranked_list.size(), 10);
+	} TestcaseEnd(insert_unique_and_replace);
+
+	Testcase(select_and_index_of)
+	{
+		auto ranked_list = ds::RankedList<int>();
+		for(int i = 99; i >= 0; --i)
+			AssertTrue(bool(ranked_list.insert(i * 2)));
+		for(size_t i = 0; i < 100; ++i)
+		{
+			auto it = ranked_list.select(i);
+			AssertTrue(bool(it));
+			ExpectEQ(*it, int(i * 2));
+			ExpectEQ(ranked_list.index_of(it), i);
+			ExpectEQ(ranked_list.at(i), int(i * 2));
+		}
+		ExpectTrue(ranked_list.select(100) == ranked_list.end());
+		ExpectEQ(ranked_list.index_of(ranked_list.end()), 100);
+	} TestcaseEnd(select_and_index_of);
+
+	Testcase(rank_and_count_range)
+	{
+		auto ranked_list = ds::RankedList<int>();
+		for(int i = 0; i < 100; ++i)
+			AssertTrue(bool(ranked_list.insert(i * 2)));
+		ExpectEQ(ranked_list.rank(-1), 0);
+		ExpectEQ(ranked_list.rank(0), 0);
+		ExpectEQ(ranked_list.rank(1), 1);
+		ExpectEQ(ranked_list.rank(50), 25);
+		ExpectEQ(ranked_list.rank(51), 26);
+		ExpectEQ(ranked_list.rank(1000), 100);
+		ExpectEQ(ranked_list.count_range(10, 20), 5);
+		ExpectEQ(ranked_list.count_range(11, 21), 5);
+		ExpectEQ(ranked_list.count_range(20, 10), 0);
+		ExpectEQ(ranked_list.count_range(-100, 1000), 100);
+	} TestcaseEnd(rank_and_count_range);
+
+	Testcase(rank_with_duplicates)
+	{
+		auto ranked_list = ds::RankedList<int>();
+		for(int i = 0; i < 30; ++i)
+			AssertTrue(bool(ranked_list.insert(i % 3)));
+		ExpectEQ(ranked_list.rank(0), 0);
+		ExpectEQ(ranked_list.rank(1), 10);
+		ExpectEQ(ranked_list.rank(2), 20);
+		ExpectEQ(ranked_list.count_range(1, 2), 10);
+		ExpectEQ(*ranked_list.position_of(1, 9), 1);
+		ExpectTrue(ranked_list.position_of(1, 10) == ranked_list.end());
+	} TestcaseEnd(rank_with_duplicates);
+
+	Testcase(remove_updates_ranks)
+	{
+		auto ranked_list = ds::RankedList<int>();
+		for(int i = 0; i < 100; ++i)
+			AssertTrue(bool(ranked_list.insert(i)));
+		for(int i = 0; i < 100; i += 2)
+			AssertTrue(ranked_list.remove(i));
+		ExpectFalse(ranked_list.remove(0));
+		AssertEQ(ranked_list.size(), 50);
+		for(size_t i = 0; i < 50; ++i)
+			ExpectEQ(*ranked_list.select(i), int(i * 2 + 1));
+		ExpectEQ(ranked_list.rank(51), 25);
+		ExpectEQ(*ranked_list.begin(), 1);
+		ExpectEQ(*ranked_list.rbegin(), 99);
+	} TestcaseEnd(remove_updates_ranks);
+
+	Testcase(reverse_iteration)
+	{
+		auto ranked_list = ds::RankedList<int>();
+		for(int i = 0; i < 20; ++i)
+			AssertTrue(bool(ranked_list.insert(i)));
+		int i = 19;
+		for(auto it = ranked_list.rbegin(); it != ranked_list.rend(); --it)
+			ExpectEQ(*it, i--);
+		ExpectEQ(i, -1);
+	} TestcaseEnd(reverse_iteration);
+
+	Testcase(destroy_destructs_all)
+	{
+		{
+			auto ranked_list = ds::RankedList<Counter>();
+			for(int i = 0; i < 10; ++i)
+				AssertTrue(bool(ranked_list.emplace(i)));
+			ExpectEQ(Counter::active(), 10);
+			auto copy_ = ranked_list;
+			ExpectEQ(Counter::active(), 20);
+			copy_.destroy();
+			ExpectEQ(Counter::active(), 10);
+			ExpectEQ(copy_.size(), 0);
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(destroy_destructs_all);
+
+	Testcase(iterable_traits)
+	{
+		using ranked_list_t = ds::RankedList<int>;
+		ExpectTrue(ds::is_same<ds::traits::iterable<ranked_list_t>::element_t,int>::value);
+		ExpectTrue(ds::is_same<ds::traits::iterable<ranked_list_t>::size_t,size_t>::value);
+		ExpectTrue(ds::is_same<ds::traits::iterable<ranked_list_t>::forward_iterator_t,ds::RankedListIterator<int>>::value);
+		ExpectTrue(ds::is_same<ds::traits::iterable<ranked_list_t>::const_forward_iterator_t,ds::ConstRankedListIterator<int>>::value);
+	} TestcaseEnd(iterable_traits);
+
+};
+
+TestRegistry(ranked_list_test)
+{
+	Register(default_construct_throws_none)
+	Register(default_construct_empty)
+	Register(insert_keeps_order)
+	Register(insert_unique_and_replace)
+	Register(select_and_index_of)
+	Register(rank_and_count_range)
+	Register(rank_with_duplicates)
+	Register(remove_updates_ranks)
+	Register(reverse_iteration)
+	Register(destroy_destructs_all)
+	Register(iterable_traits)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return ranked_list_test().run_all(reporter_t<ranked_list_test>(pptest::normal));
+}
@@ -0,0 +1,475 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/array>
+#include <ds/simd>
+#include <limits>
+#include "../random"
+
+template class ds::Array<float>;
+
+static float const nan_ = std::numeric_limits<float>::quiet_NaN();
+
+// the order of a sequential search, as built with DS_simd=0
+static size_t
+scalar_argmin(float const * begin_, size_t size_)
+{
+	size_t index_ = 0;
+	for(size_t i = 1; i < size_; ++i)
+		if(begin_[i] < begin_[index_])
+			index_ = i;
+	return index_;
+}
+
+static size_t
+scalar_argmax(float const * begin_, size_t size_)
+{
+	size_t index_ = 0;
+	for(size_t i = 1; i < size_; ++i)
+		if(begin_[index_] < begin_[i])
+			index_ = i;
+	return index_;
+}
+
+template <class F>
+static ds::Array<float>
+make_array(size_t size_, F && value_)
+{
+	auto array_ = ds::Array<float>(size_, ds::noinit);
+	for(size_t i = 0; i < size_; ++i)
+		new(&array_[i]) float(value_(i));
+	return array_;
+}
+
+// size_ chars drawn from the first alphabet_ (at most 28) chars of chars_, past 0x7F included
+static ds::Array<char>
+make_chars(size_t size_, size_t alphabet_, uint32_t seed_)
+{
+	static char const chars_[] = "ab\x80\xFF" "cdefghijklmnopqrstuvwxyz";
+	auto array_ = ds::Array<char>(size_, 'a');
+	for(auto & char_ : array_)
+		char_ = chars_[next_random(seed_) % alphabet_];
+	return array_;
+}
+
+// index of the first occurrence of needle_, as a sequential search
+static size_t
+brute_find(char const * begin_, size_t size_, char const * needle_, size_t length_)
+{
+	if(length_ > size_)
+		return size_;
+	for(size_t i = 0; i + length_ <= size_; ++i)
+		if(memcmp(begin_ + i, needle_, length_) == 0)
+			return i;
+	return size_;
+}
+
+static size_t
+brute_rfind(char const * begin_, size_t size_, char const * needle_, size_t length_)
+{
+	if(length_ == 0 || length_ > size_)
+		return size_;
+	for(size_t i = size_ - length_ + 1; i-- > 0;)
+		if(memcmp(begin_ + i, needle_, length_) == 0)
+			return i;
+	return size_;
+}
+
+// calls func_ once per instruction set the cpu supports
+template <class F>
+static void
+for_each_isa(F && func_)
+{
+	for(int isa_ = 0; isa_ <= int(ds::simd::detected_isa()); ++isa_)
+	{
+		ds::simd::set_active_isa(ds::simd::isa(isa_));
+		func_();
+	}
+	ds::simd::set_active_isa(ds::simd::detected_isa());
+}
+
+Test(simd_test)
+{
+	TestInit(simd_test);
+
+	Testcase(find_min_max_nan_first)
+	{
+		for_each_isa([&]{
+			auto array_ = ds::Array<float>({ nan_, 2.f, 3.f });
+			ExpectEQ(ds::find_min(array_) - array_.begin(), 0);
+			ExpectEQ(ds::find_max(array_) - array_.begin(), 0);
+			auto large_ = make_array(40, [](size_t i) { return float(40 - i); });
+			large_[0] = nan_;
+			ExpectEQ(ds::find_min(large_) - large_.begin(), 0);
+			ExpectEQ(ds::find_max(large_) - large_.begin(), 0);
+		});
+	} TestcaseEnd(find_min_max_nan_first);
+
+	Testcase(find_min_max_nan_skipped)
+	{
+		for_each_isa([&]{
+			auto array_ = ds::Array<float>({ 2.f, nan_, 1.f, 3.f });
+			ExpectEQ(ds::find_min(array_) - array_.begin(), 2);
+			ExpectEQ(ds::find_max(array_) - array_.begin(), 3);
+			for(size_t size_ : { 1, 7, 8, 16, 17, 40, 67 })
+			{
+				for(size_t at_ = 0; at_ < size_; ++at_)
+				{
+					auto large_ = make_array(size_, [](size_t i) { return float((i * 7) % 13); });
+					large_[at_] = nan_;
+					if(at_ + 3 < size_)
+						large_[at_ + 3] = nan_;
+					size_t const min_ = size_t(ds::find_min(large_) - large_.begin());
+					size_t const max_ = size_t(ds::find_max(large_) - large_.begin());
+					ExpectLT(min_, size_);
+					ExpectLT(max_, size_);
+					ExpectEQ(min_, scalar_argmin(large_.begin(), size_));
+					ExpectEQ(max_, scalar_argmax(large_.begin(), size_));
+				}
+			}
+		});
+	} TestcaseEnd(find_min_max_nan_skipped);
+
+	Testcase(find_min_max_all_nan)
+	{
+		for_each_isa([&]{
+			auto array_ = ds::Array<float>(33, nan_);
+			ExpectEQ(ds::find_min(array_) - array_.begin(), 0);
+			ExpectEQ(ds::find_max(array_) - array_.begin(), 0);
+			ExpectEQ(ds::simd::argmin(array_.begin(), 0), 0);
+		});
+	} TestcaseEnd(find_min_max_all_nan);
+
+	Testcase(min_max_first_occurrence)
+	{
+		for_each_isa([&]{
+			auto array_ = ds::Array<float>(50, 5.f);
+			array_[20] = -1.f;
+			array_[45] = -1.f;
+			array_[3]  = 9.f;
+			array_[30] = 9.f;
+			ExpectEQ(ds::find_min(array_) - array_.begin(), 20);
+			ExpectEQ(ds::find_max(array_) - array_.begin(), 3);
+			ExpectEQ(ds::simd::min(array_.begin(), array_.size()), -1.f);
+			ExpectEQ(ds::simd::max(array_.begin(), array_.size()), 9.f);
+		});
+	} TestcaseEnd(min_max_first_occurrence);
+
+	// every offset from an aligned block and every size across a few vectors,
+	//   so each kernel runs with an unaligned head and a partial tail
+	Testcase(unaligned_tails_int)
+	{
+		alignas(64) int32_t block_[128];
+		alignas(64) int32_t other_[128];
+		for(size_t i = 0; i < 128; ++i)
+			block_[i] = other_[i] = int32_t((i * 37) % 101) - 50;
+		for_each_isa([&]{
+			for(size_t offset_ = 0; offset_ < 4; ++offset_)
+			{
+				for(size_t size_ = 0; size_ + offset_ <= 80; ++size_)
+				{
+					int32_t const * begin_ = block_ + offset_;
+					int64_t sum_ = 0, dot_ = 0;
+					size_t  count_ = 0;
+					for(size_t i = 0; i < size_; ++i)
+					{
+						sum_   += begin_[i];
+						dot_   += int64_t(begin_[i]) * begin_[i];
+						count_ += size_t(begin_[i] == 7);
+					}
+					ExpectEQ(ds::simd::sum(begin_, size_), sum_);
+					ExpectEQ(ds::simd::dot(begin_, other_ + offset_, size_), dot_);
+					ExpectEQ(ds::simd::count(begin_, size_, 7), count_);
+					ExpectTrue(ds::simd::equal(begin_, other_ + offset_, size_));
+					if(size_ == 0)
+						continue;
+					size_t const last_ = size_ - 1;
+					ExpectEQ(ds::simd::find(begin_, size_, begin_[last_]) <= last_, true);
+					ExpectEQ(ds::simd::find(begin_, size_, 1000), size_);
+					int32_t min_ = begin_[0], max_ = begin_[0];
+					for(size_t i = 1; i < size_; ++i)
+					{
+						min_ = ds::min(min_, begin_[i]);
+						max_ = ds::max(max_, begin_[i]);
+					}
+					ExpectEQ(ds::simd::min(begin_, size_), min_);
+					ExpectEQ(ds::simd::max(begin_, size_), max_);
+					other_[offset_ + last_] += 1;
+					ExpectFalse(ds::simd::equal(begin_, other_ + offset_, size_));
+					other_[offset_ + last_] -= 1;
+				}
+			}
+		});
+	} TestcaseEnd(unaligned_tails_int);
+
+	Testcase(unaligned_tails_float)
+	{
+		alignas(64) float block_[128];
+		for(size_t i = 0; i < 128; ++i)
+			block_[i] = float(int((i * 37) % 101) - 50);
+		for_each_isa([&]{
+			for(size_t offset_ = 0; offset_ < 4; ++offset_)
+			{
+				for(size_t size_ = 1; size_ + offset_ <= 80; ++size_)
+				{
+					float const * begin_ = block_ + offset_;
+					// small integers sum exactly in any order
+					float sum_ = 0.f;
+					for(size_t i = 0; i < size_; ++i)
+						sum_ += begin_[i];
+					ExpectEQ(ds::simd::sum(begin_, size_), sum_);
+					ExpectEQ(ds::simd::argmin(begin_, size_), scalar_argmin(begin_, size_));
+					ExpectEQ(ds::simd::argmax(begin_, size_), scalar_argmax(begin_, size_));
+					ExpectEQ(ds::simd::find(begin_, size_, begin_[size_ - 1]) < size_, true);
+				}
+			}
+		});
+	} TestcaseEnd(unaligned_tails_float);
+
+	// the generic algorithms of common reroute int32_t ranges to the kernels, int64_t
+	//   ones take the sequential path and must agree with them
+	Testcase(generic_algorithms_rerouted)
+	{
+		alignas(64) int32_t block_[160];
+		alignas(64) int64_t wide_[160];
+		for(size_t i = 0; i < 160; ++i)
+			wide_[i] = block_[i] = int32_t((i * 29) % 11);
+		for_each_isa([&]{
+			for(size_t offset_ = 0; offset_ < 4; ++offset_)
+			{
+				for(size_t size_ = 0; size_ + offset_ <= 150; size_ += 7)
+				{
+					// the iterators are passed as temporaries, the sequential find() advances an lvalue one
+					for(int32_t value_ : { 0, 3, 10, 11 })
+					{
+						for(size_t skip_ = 0; skip_ < 4; ++skip_)
+						{
+							size_t const found_ = ds::find(int64_t(value_), wide_ + offset_, wide_ + offset_ + size_, skip_);
+							size_t const count_ = ds::count(int64_t(value_), wide_ + offset_, wide_ + offset_ + size_, skip_);
+							ExpectEQ(ds::find(value_, block_ + offset_, block_ + offset_ + size_, skip_), found_);
+							ExpectEQ(ds::count(value_, block_ + offset_, block_ + offset_ + size_, skip_), count_);
+						}
+					}
+				}
+			}
+			auto array_ = ds::Array<int32_t>(size_t(100), 4);
+			auto wide_array_ = ds::Array<int64_t>(size_t(100), int64_t(4));
+			array_[37] = wide_array_[37] = 9;
+			array_[81] = wide_array_[81] = 9;
+			ExpectEQ(ds::find(9, array_), 37);
+			ExpectEQ(ds::find(9, array_, 1), 81);
+			ExpectEQ(ds::find(9, array_, 2), size_t(-1));
+			ExpectEQ(ds::count(9, array_), 2);
+			ExpectEQ(ds::count(4, array_, 10), ds::count(int64_t(4), wide_array_, 10));
+			ExpectEQ(ds::sum(array_), ds::sum(wide_array_));
+			ExpectEQ(ds::dot(array_, array_), ds::dot(wide_array_, wide_array_));
+			auto copy_ = ds::Array<int32_t>(array_);
+			ExpectTrue(ds::equals(array_, copy_));
+			copy_[99] = 0;
+			ExpectFalse(ds::equals(array_, copy_));
+			ds::fill(copy_, 6);
+			ExpectEQ(ds::count(6, copy_), 100);
+			ExpectEQ(ds::sum(copy_), 600);
+		});
+	} TestcaseEnd(generic_algorithms_rerouted);
+
+	// the char kernels at every offset from an allocation, on exactly sized heap buffers
+	//   so that a read past the end is caught
+	Testcase(char_find_count_rfind)
+	{
+		for_each_isa([&]{
+			for(size_t size_ = 0; size_ <= 150; size_ += (size_ < 70 ? 1 : 13))
+			{
+				auto const chars_ = make_chars(size_, 6, uint32_t(size_) + 1);
+				for(size_t offset_ = 0; offset_ <= ds::min<size_t>(size_, 33); ++offset_)
+				{
+					char const * begin_ = chars_.begin() + offset_;
+					size_t const n = size_ - offset_;
+					for(char value_ : { 'a', 'd', '\x80', '\xFF', 'z' })
+					{
+						size_t first_ = n, last_ = n, count_ = 0;
+						for(size_t i = 0; i < n; ++i)
+						{
+							if(begin_[i] != value_)
+								continue;
+							first_ = first_ == n ? i : first_;
+							last_  = i;
+							++count_;
+						}
+						AssertEQ(ds::simd::find(begin_, n, value_), first_);
+						AssertEQ(ds::simd::rfind(begin_, n, value_), last_);
+						AssertEQ(ds::simd::count(begin_, n, value_), count_);
+					}
+				}
+			}
+		});
+	} TestcaseEnd(char_find_count_rfind);
+
+	Testcase(char_string_length)
+	{
+		for_each_isa([&]{
+			for(size_t size_ = 1; size_ <= 130; ++size_)
+			{
+				auto chars_ = ds::Array<char>(size_, 'x');
+				chars_[size_ - 1] = '\0';
+				for(size_t offset_ = 0; offset_ < size_; ++offset_)
+				{
+					size_t const length_ = size_ - 1 - offset_;
+					AssertEQ(ds::simd::string_length(chars_.begin() + offset_), length_);
+					AssertEQ(ds::string_length(chars_.begin() + offset_), length_);
+					for(size_t max_ : { size_t(0), size_t(1), length_ / 2, length_, length_ + 1 })
+						AssertEQ(ds::simd::string_length(chars_.begin() + offset_, max_), ds::min(max_, length_));
+				}
+				// chars past 0x7F are not terminators
+				if(size_ > 1)
+				{
+					chars_[0] = '\x80';
+					AssertEQ(ds::string_length(chars_.begin()), size_ - 1);
+				}
+			}
+		});
+	} TestcaseEnd(char_string_length);
+
+	Testcase(char_string_mismatch)
+	{
+		for_each_isa([&]{
+			for(size_t size_ = 0; size_ <= 100; ++size_)
+			{
+				auto const lhs_ = make_chars(size_ + 3, 24, uint32_t(size_));
+				for(size_t offset_ = 0; offset_ < 3; ++offset_)
+				{
+					// rhs_ on its own allocation, at another offset than lhs_
+					auto rhs_ = ds::Array<char>(size_ + 1, 'a');
+					memcpy(rhs_.begin() + 1, lhs_.begin() + offset_, size_);
+					char const * lbegin_ = lhs_.begin() + offset_;
+					AssertEQ(ds::simd::string_mismatch(lbegin_, rhs_.begin() + 1, size_), size_);
+					AssertEQ(ds::string_compare(lbegin_, rhs_.begin() + 1, size_, size_), 0);
+					for(size_t at_ = 0; at_ < size_; at_ += 1 + at_ / 8)
+					{
+						char const saved_ = rhs_[at_ + 1];
+						rhs_[at_ + 1] = char(saved_ ^ '\x80');
+						AssertEQ(ds::simd::string_mismatch(lbegin_, rhs_.begin() + 1, size_), at_);
+						AssertEQ(ds::string_mismatch(lbegin_, rhs_.begin() + 1, size_), at_);
+						// ordered as char, the same as the sequential comparison
+						int const expected_ = lbegin_[at_] < rhs_[at_ + 1] ? -1 : 1;
+						AssertEQ(ds::string_compare(lbegin_, rhs_.begin() + 1, size_, size_), expected_);
+						rhs_[at_ + 1] = saved_;
+					}
+				}
+			}
+		});
+	} TestcaseEnd(char_string_mismatch);
+
+	Testcase(char_string_find_rfind)
+	{
+		// periodic needles and small alphabets make many partial matches
+		char const * const needles_[] { "", "a", "ab", "aa", "aaa", "aab", "aba", "abab", "ababa", "baaab",
+			"\x80\xFF", "aaaaaaaaaaaaaaaaaaab", "abaabaabaabaabaabaab", "abcdefghijklmnopq", "\xFF\xFF\xFF" "a" };
+		for_each_isa([&]{
+			for(size_t alphabet_ : { size_t(2), size_t(4), size_t(20) })
+			{
+				for(size_t size_ : { size_t(0), size_t(1), size_t(5), size_t(16), size_t(31), size_t(64), size_t(65), size_t(200), size_t(3000) })
+				{
+					auto const chars_ = make_chars(size_, alphabet_, uint32_t(size_ * alphabet_) + 1);
+					for(size_t offset_ = 0; offset_ < ds::min<size_t>(size_ + 1, 4); ++offset_)
+					{
+						char const * begin_ = chars_.begin() + offset_;
+						size_t const n = size_ - offset_;
+						for(char const * needle_ : needles_)
+						{
+							size_t const length_ = ds::string_length(needle_);
+							AssertEQ(ds::simd::string_find(begin_, n, needle_, length_), brute_find(begin_, n, needle_, length_));
+							AssertEQ(ds::simd::string_rfind(begin_, n, needle_, length_), brute_rfind(begin_, n, needle_, length_));
+						}
+						// needles taken from the haystack itself are always found
+						if(n >= 10)
+						{
+							char const * needle_ = begin_ + n / 3;
+							AssertEQ(ds::simd::string_find(begin_, n, needle_, 7), brute_find(begin_, n, needle_, 7));
+							AssertEQ(ds::simd::string_rfind(begin_, n, needle_, 7), brute_rfind(begin_, n, needle_, 7));
+						}
+					}
+				}
+			}
+			// long runs of candidates that fail late, where the two-way search takes over
+			auto long_ = ds::Array<char>(size_t(20000), 'a');
+			char const needle_[] = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab";
+			AssertEQ(ds::simd::string_find(long_.begin(), long_.size(), needle_, 32), long_.size());
+			long_[19999] = 'b';
+			AssertEQ(ds::simd::string_find(long_.begin(), long_.size(), needle_, 32), 19999 - 31);
+			AssertEQ(ds::simd::string_rfind(long_.begin(), long_.size(), needle_, 32), 19999 - 31);
+		});
+	} TestcaseEnd(char_string_find_rfind);
+
+	Testcase(char_string_find_any)
+	{
+		char const set_[] = "\x80zyxwvutsrqponmlkjihgfedcb";
+		for_each_isa([&]{
+			for(size_t size_ : { size_t(0), size_t(1), size_t(15), size_t(16), size_t(17), size_t(100), size_t(1000) })
+			{
+				// mostly 'a', so that most sets are found late or not at all
+				auto chars_ = ds::Array<char>(size_, 'a');
+				uint32_t seed_ = uint32_t(size_) + 9;
+				for(size_t i = 0; i < size_ / 20; ++i)
+					chars_[next_random(seed_) % size_] = set_[next_random(seed_) % 27];
+				for(size_t offset_ = 0; offset_ < ds::min<size_t>(size_ + 1, 3); ++offset_)
+				{
+					char const * begin_ = chars_.begin() + offset_;
+					size_t const n = size_ - offset_;
+					for(size_t set_size_ = 0; set_size_ <= 27; ++set_size_)
+					{
+						size_t expected_ = n;
+						for(size_t i = 0; i < n && expected_ == n; ++i)
+							for(size_t k = 0; k < set_size_; ++k)
+								if(begin_[i] == set_[k])
+									expected_ = i;
+						AssertEQ(ds::simd::string_find_any(begin_, n, set_, set_size_), expected_);
+					}
+				}
+			}
+		});
+	} TestcaseEnd(char_string_find_any);
+
+	Testcase(fill_stays_in_range)
+	{
+		for_each_isa([&]{
+			for(size_t offset_ = 0; offset_ < 4; ++offset_)
+			{
+				for(size_t size_ = 0; size_ + offset_ <= 70; ++size_)
+				{
+					alignas(64) int32_t block_[72];
+					for(auto & value_ : block_)
+						value_ = -1;
+					ds::simd::fill(block_ + offset_, size_, 3);
+					for(size_t i = 0; i < 72; ++i)
+						ExpectEQ(block_[i], i >= offset_ && i < offset_ + size_ ? 3 : -1);
+				}
+			}
+		});
+	} TestcaseEnd(fill_stays_in_range);
+
+};
+
+TestRegistry(simd_test)
+{
+	Register(find_min_max_nan_first)
+	Register(find_min_max_nan_skipped)
+	Register(find_min_max_all_nan)
+	Register(min_max_first_occurrence)
+	Register(unaligned_tails_int)
+	Register(unaligned_tails_float)
+	Register(generic_algorithms_rerouted)
+	Register(char_find_count_rfind)
+	Register(char_string_length)
+	Register(char_string_mismatch)
+	Register(char_string_find_rfind)
+	Register(char_string_find_any)
+	Register(fill_stays_in_range)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return simd_test().run_all(reporter_t<simd_test>(pptest::normal));
+}
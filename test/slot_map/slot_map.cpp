@@ -0,0 +1,256 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/slot_map>
+#include <ds/array>
+#include "../counter"
+#include "../random"
+
+using map_t    = ds::SlotMap<int>;
+using handle_t = ds::SlotMapHandle;
+
+template class ds::SlotMap<int>;
+
+// every handle ever given out, and the value it refers to while alive
+struct Given
+{
+	handle_t handle;
+	int      value;
+	bool     alive;
+};
+
+// fails every allocation once allowed runs out
+struct BudgetAllocator
+{
+	static size_t allowed;
+
+	static void *
+	allocate(size_t size_, ds::align_t align_) noexcept
+	{
+		if(allowed == 0)
+			return nullptr;
+		--allowed;
+		return ds::default_nt_allocator::allocate(size_, align_);
+	}
+
+	static void
+	deallocate(void * block_) noexcept
+	{
+		ds::default_nt_allocator::deallocate(block_);
+	}
+
+};
+
+size_t BudgetAllocator::allowed = 0;
+
+Test(slot_map_test)
+{
+	TestInit(slot_map_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(null_map)
+	{
+		map_t map_;
+		ExpectTrue(!map_);
+		ExpectEQ(map_.size(), 0);
+		ExpectFalse(map_.contains(handle_t()));
+		ExpectFalse(map_.erase(handle_t()));
+		ExpectNull(map_.get(handle_t()));
+		ExpectThrow(map_t::invalid_handle const &, map_.at(handle_t()));
+		handle_t const handle_ = map_.insert(7);
+		ExpectTrue(handle_ != handle_t());
+		ExpectTrue(bool(map_));
+		ExpectEQ(map_.at(handle_), 7);
+	} TestcaseEnd(null_map);
+
+	Testcase(handle_layout)
+	{
+		handle_t const handle_ { 5, 9 };
+		ExpectEQ(handle_.index(), 5);
+		ExpectEQ(handle_.generation(), 9);
+		ExpectEQ(handle_.value, (uint64_t(9) << 32) | 5);
+		ExpectTrue(handle_t(handle_.value) == handle_);
+		ExpectEQ(ds::Hasher<handle_t>::hash(handle_), ds::Hasher<uint64_t>::hash(handle_.value));
+	} TestcaseEnd(handle_layout);
+
+	// a slot given back is reused with a new generation, its earlier handles going stale
+	Testcase(stale_handles)
+	{
+		auto map_ = map_t(size_t(0));
+		handle_t const a_ = map_.insert(1);
+		handle_t const b_ = map_.insert(2);
+		AssertTrue(map_.erase(a_));
+		ExpectFalse(map_.contains(a_));
+		ExpectFalse(map_.erase(a_));
+		ExpectNull(map_.get(a_));
+		ExpectThrow(map_t::invalid_handle const &, map_.at(a_));
+		handle_t const c_ = map_.insert(3);
+		ExpectEQ(c_.index(), a_.index());
+		ExpectTrue(c_.generation() != a_.generation());
+		ExpectFalse(map_.contains(a_));
+		ExpectEQ(map_[c_], 3);
+		ExpectEQ(map_[b_], 2);
+		// out of range and never given
+		ExpectFalse(map_.contains(handle_t(100, 1)));
+		ExpectFalse(map_.contains(handle_t(b_.index(), b_.generation() + 2)));
+	} TestcaseEnd(stale_handles);
+
+	Testcase(random_operations)
+	{
+		uint32_t seed_ = 7;
+		auto map_   = map_t(size_t(0));
+		auto given_ = ds::Array<Given>(size_t(0), Given {});
+		size_t alive_count_ = 0;
+		bool matches_ = true;
+		for(size_t step_ = 0; step_ < 30000 && matches_; ++step_)
+		{
+			uint32_t const op_ = next_random(seed_) % 4;
+			if(op_ <= 1 || given_.size() == 0)
+			{
+				int const value_ = int(next_random(seed_));
+				handle_t const handle_ = map_.insert(value_);
+				matches_ = matches_ && map_.contains(handle_);
+				given_ += ds::Array<Given>({ Given { handle_, value_, true } });
+				++alive_count_;
+			}
+			else
+			{
+				Given & entry_ = given_[next_random(seed_) % given_.size()];
+				if(op_ == 2)
+				{
+					matches_ = matches_ && map_.erase(entry_.handle) == entry_.alive;
+					alive_count_ -= entry_.alive;
+					entry_.alive = false;
+				}
+				else if(entry_.alive)
+				{
+					entry_.value = int(next_random(seed_));
+					map_.at(entry_.handle) = entry_.value;
+				}
+			}
+			matches_ = matches_ && map_.size() == alive_count_;
+		}
+		ExpectTrue(matches_);
+		for(auto const & entry_ : given_)
+		{
+			ExpectEQ(map_.contains(entry_.handle), entry_.alive);
+			if(entry_.alive)
+				ExpectEQ(map_[entry_.handle], entry_.value);
+		}
+		// the dense elements are exactly the alive ones, each one reachable from its handle
+		int const * begin_ = map_.begin();
+		for(size_t i = 0; i < map_.size(); ++i)
+		{
+			handle_t const handle_ = map_.handle_at(i);
+			AssertTrue(map_.contains(handle_));
+			ExpectTrue(map_.get(handle_) == begin_ + i);
+		}
+		ExpectEQ(size_t(map_.end() - map_.begin()), alive_count_);
+	} TestcaseEnd(random_operations);
+
+	Testcase(clear_makes_handles_stale)
+	{
+		auto map_ = map_t(size_t(4));
+		handle_t handles_[10];
+		for(int i = 0; i < 10; ++i)
+			handles_[i] = map_.insert(i);
+		map_.clear();
+		ExpectEQ(map_.size(), 0);
+		ExpectTrue(bool(map_));
+		for(auto const & handle_ : handles_)
+			ExpectFalse(map_.contains(handle_));
+		// every slot is reused before a new one is added
+		for(int i = 0; i < 10; ++i)
+			ExpectTrue(map_.insert(i).index() < 10);
+		ExpectTrue(map_.insert(10).index() == 10);
+	} TestcaseEnd(clear_makes_handles_stale);
+
+	Testcase(copy_move_swap)
+	{
+		auto map_ = map_t(size_t(0));
+		handle_t const a_ = map_.insert(1);
+		handle_t const b_ = map_.insert(2);
+		auto copy_ = map_t(map_);
+		ExpectEQ(copy_.size(), 2);
+		copy_[a_] = 10;
+		ExpectEQ(map_[a_], 1);
+		auto moved_ = map_t(ds::move(map_));
+		ExpectTrue(!map_);
+		ExpectEQ(moved_[b_], 2);
+		moved_.erase(b_);
+		moved_.swap(copy_);
+		ExpectTrue(moved_.contains(b_));
+		ExpectFalse(copy_.contains(b_));
+		map_ = ds::move(moved_);
+		ExpectTrue(!moved_);
+		ExpectEQ(moved_.size(), 0);
+		ExpectFalse(moved_.contains(b_));
+		ExpectEQ(map_[a_], 10);
+		map_.destroy();
+		ExpectTrue(!map_);
+		ExpectEQ(map_.size(), 0);
+		ExpectFalse(map_.contains(a_));
+		ExpectTrue(map_.contains(map_.insert(4)));
+	} TestcaseEnd(copy_move_swap);
+
+	Testcase(non_trivial_elements)
+	{
+		{
+			auto map_ = ds::SlotMap<Counter>(size_t(0));
+			handle_t handles_[100];
+			for(int i = 0; i < 100; ++i)
+				handles_[i] = map_.insert(i);
+			ExpectEQ(Counter::active(), 100);
+			for(int i = 0; i < 100; i += 3)
+				AssertTrue(map_.erase(handles_[i]));
+			ExpectEQ(Counter::active(), 66);
+			for(int i = 1; i < 100; i += 3)
+				ExpectEQ(map_[handles_[i]].value(), i);
+			ExpectTrue(Counter::no_copies());
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(non_trivial_elements);
+
+	// a slot pushed for an insert that then fails is not left behind
+	Testcase(failed_insert_drops_fresh_slot)
+	{
+		using budget_map_t = ds::SlotMap<int,BudgetAllocator>;
+		for(size_t allowed_ : { size_t(1), size_t(2) })
+		{
+			budget_map_t map_;
+			BudgetAllocator::allowed = allowed_;
+			ExpectEQ(map_.insert(1), handle_t());
+			ExpectEQ(map_.size(), 0);
+			BudgetAllocator::allowed = size_t(-1);
+			handle_t const handle_ = map_.insert(2);
+			AssertTrue(map_.contains(handle_));
+			ExpectEQ(handle_.index(), 0);
+			ExpectEQ(handle_.generation(), 1);
+			ExpectEQ(map_[handle_], 2);
+		}
+	} TestcaseEnd(failed_insert_drops_fresh_slot);
+
+};
+
+TestRegistry(slot_map_test)
+{
+	Register(null_map)
+	Register(handle_layout)
+	Register(stale_handles)
+	Register(random_operations)
+	Register(clear_makes_handles_stale)
+	Register(copy_move_swap)
+	Register(non_trivial_elements)
+	Register(failed_insert_drops_fresh_slot)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return slot_map_test().run_all(reporter_t<slot_map_test>(pptest::normal));
+}
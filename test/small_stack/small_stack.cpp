@@ -0,0 +1,183 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/small_stack>
+#include "../counter"
+
+template class ds::SmallStack<4,int>;
+template class ds::SmallStack<4,int,ds::allocators::NTMalloc>;
+template class ds::SmallStack<4,Counter>;
+
+using stack_t         = ds::SmallStack<4,int>;
+using realloc_stack_t = ds::SmallStack<4,int,ds::allocators::NTMalloc>;
+using counter_stack_t = ds::SmallStack<4,Counter>;
+
+template <class S>
+static bool
+holds_sequence(S const & stack_, int size_)
+{
+	if(stack_.size() != size_t(size_))
+		return false;
+	for(int i = 0; i < size_; ++i)
+		if(stack_[size_t(i)] != i)
+			return false;
+	return true;
+}
+
+Test(small_stack_test)
+{
+	TestInit(small_stack_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(inline_until_full)
+	{
+		auto stack_ = stack_t();
+		ExpectTrue(stack_.is_inline());
+		ExpectEQ(stack_.capacity(), 4);
+		for(int i = 0; i < 4; ++i)
+			AssertNotNull(stack_.push(i));
+		ExpectTrue(stack_.is_inline());
+		ExpectNull(stack_.push_noresize(4));
+		AssertNotNull(stack_.push(4));
+		ExpectFalse(stack_.is_inline());
+		ExpectTrue(stack_.capacity() >= 16);
+		ExpectTrue(holds_sequence(stack_, 5));
+	} TestcaseEnd(inline_until_full);
+
+	Testcase(spills_and_grows)
+	{
+		auto stack_   = stack_t();
+		auto realloc_ = realloc_stack_t();
+		for(int i = 0; i < 10000; ++i)
+		{
+			AssertNotNull(stack_.push(i));
+			AssertNotNull(realloc_.push(i));
+		}
+		ExpectTrue(holds_sequence(stack_, 10000));
+		ExpectTrue(holds_sequence(realloc_, 10000));
+		for(int i = 9999; i >= 0; --i)
+		{
+			ExpectEQ(realloc_.top(), i);
+			AssertTrue(realloc_.pop());
+		}
+		ExpectFalse(realloc_.pop());
+	} TestcaseEnd(spills_and_grows);
+
+	Testcase(reserve_past_inline)
+	{
+		auto stack_ = stack_t(size_t(3));
+		ExpectTrue(stack_.is_inline());
+		auto large_ = stack_t(size_t(100));
+		ExpectFalse(large_.is_inline());
+		ExpectEQ(large_.capacity(), 100);
+		ExpectEQ(large_.size(), 0);
+		auto filled_ = stack_t(size_t(6), 7);
+		ExpectFalse(filled_.is_inline());
+		ExpectEQ(filled_.size(), 6);
+		ExpectEQ(filled_[5], 7);
+	} TestcaseEnd(reserve_past_inline);
+
+	Testcase(move_inline_and_allocated)
+	{
+		auto inline_ = stack_t({ 0, 1, 2 });
+		auto moved_  = stack_t(ds::move(inline_));
+		ExpectTrue(moved_.is_inline());
+		ExpectTrue(holds_sequence(moved_, 3));
+		ExpectEQ(inline_.size(), 0);
+		ExpectTrue(inline_.is_inline());
+		auto heap_ = stack_t();
+		for(int i = 0; i < 20; ++i)
+			AssertNotNull(heap_.push(i));
+		int const * array_ = heap_.begin();
+		moved_ = ds::move(heap_);
+		// allocated storage is taken over
+		ExpectTrue(moved_.begin() == array_);
+		ExpectTrue(holds_sequence(moved_, 20));
+		ExpectTrue(heap_.is_inline());
+		ExpectEQ(heap_.capacity(), 4);
+		AssertNotNull(heap_.push(0));
+		ExpectTrue(holds_sequence(heap_, 1));
+	} TestcaseEnd(move_inline_and_allocated);
+
+	Testcase(copy_and_swap)
+	{
+		auto small_ = stack_t({ 0, 1 });
+		auto large_ = stack_t();
+		for(int i = 0; i < 9; ++i)
+			AssertNotNull(large_.push(i));
+		auto copy_ = large_;
+		ExpectTrue(holds_sequence(copy_, 9));
+		ExpectTrue(copy_.begin() != large_.begin());
+		small_.swap(large_);
+		ExpectTrue(holds_sequence(small_, 9));
+		ExpectTrue(holds_sequence(large_, 2));
+		ExpectTrue(large_.is_inline());
+		ExpectFalse(small_.is_inline());
+	} TestcaseEnd(copy_and_swap);
+
+	Testcase(destroy_returns_to_inline)
+	{
+		auto stack_ = stack_t();
+		for(int i = 0; i < 10; ++i)
+			AssertNotNull(stack_.push(i));
+		stack_.destroy();
+		ExpectTrue(stack_.is_inline());
+		ExpectEQ(stack_.size(), 0);
+		ExpectEQ(stack_.capacity(), 4);
+	} TestcaseEnd(destroy_returns_to_inline);
+
+	Testcase(non_trivial_elements)
+	{
+		{
+			auto stack_ = counter_stack_t();
+			for(int i = 0; i < 4; ++i)
+				AssertNotNull(stack_.push(i));
+			ExpectTrue(Counter::no_moves());
+			for(int i = 4; i < 40; ++i)
+				AssertNotNull(stack_.push(i));
+			ExpectEQ(Counter::active(), 40);
+			auto copy_ = stack_;
+			ExpectEQ(Counter::active(), 80);
+			auto small_ = counter_stack_t({ Counter(1), Counter(2) });
+			small_.swap(copy_);
+			ExpectEQ(small_.size(), 40);
+			ExpectEQ(copy_.size(), 2);
+			ExpectEQ(Counter::active(), 82);
+			for(size_t i = 0; i < 40; ++i)
+				ExpectEQ(small_[i].value(), int(i));
+			ExpectEQ(copy_[1].value(), 2);
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(non_trivial_elements);
+
+	Testcase(at_out_of_bounds)
+	{
+		auto stack_ = stack_t({ 1 });
+		ExpectEQ(stack_.at(0), 1);
+		ExpectThrow(stack_t::index_out_of_bounds const &, stack_.at(1));
+	} TestcaseEnd(at_out_of_bounds);
+
+};
+
+TestRegistry(small_stack_test)
+{
+	Register(inline_until_full)
+	Register(spills_and_grows)
+	Register(reserve_past_inline)
+	Register(move_inline_and_allocated)
+	Register(copy_and_swap)
+	Register(destroy_returns_to_inline)
+	Register(non_trivial_elements)
+	Register(at_out_of_bounds)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return small_stack_test().run_all(reporter_t<small_stack_test>(pptest::normal));
+}
@@ -0,0 +1,173 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/soa>
+#include "../counter"
+
+using row_t = ds::Tuple<int,double,char>;
+using soa_t = ds::SoA<row_t>;
+
+template class ds::SoA<row_t>;
+
+using counter_soa_t = ds::SoA<ds::Tuple<int,Counter>>;
+
+template <class S>
+static bool
+holds_rows(S const & soa_, size_t size_)
+{
+	if(soa_.size() != size_)
+		return false;
+	for(size_t i = 0; i < size_; ++i)
+		if(soa_.template get<0>(i) != int(i) || soa_.template get<1>(i) != double(i) / 2 || soa_.template get<2>(i) != char('a' + i % 26))
+			return false;
+	return true;
+}
+
+static bool
+push_rows(soa_t & soa_, size_t begin_, size_t end_)
+{
+	for(size_t i = begin_; i < end_; ++i)
+		if(!soa_.push_back(int(i), double(i) / 2, char('a' + i % 26)))
+			return false;
+	return true;
+}
+
+Test(soa_test)
+{
+	TestInit(soa_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(null_soa)
+	{
+		soa_t soa_;
+		ExpectTrue(!soa_);
+		ExpectEQ(soa_.size(), 0);
+		ExpectEQ(soa_.capacity(), 0);
+		ExpectFalse(soa_.pop_back());
+		ExpectThrow(soa_t::null_pointer const &, soa_.at(0));
+		AssertTrue(soa_.push_back(1, 2.0, 'c'));
+		ExpectTrue(bool(soa_));
+		ExpectTrue(soa_.capacity() >= 16);
+	} TestcaseEnd(null_soa);
+
+	// every field buffer starts on its own aligned boundary, whatever the field sizes
+	Testcase(columns_aligned)
+	{
+		auto soa_ = soa_t(size_t(7));
+		AssertTrue(bool(soa_));
+		ExpectEQ(soa_.capacity(), 7);
+		ExpectEQ(uintptr_t(soa_.data<0>()) % soa_t::column_alignment, 0);
+		ExpectEQ(uintptr_t(soa_.data<1>()) % soa_t::column_alignment, 0);
+		ExpectEQ(uintptr_t(soa_.data<2>()) % soa_t::column_alignment, 0);
+		ExpectTrue(static_cast<void *>(soa_.data<1>()) >= static_cast<void *>(soa_.data<0>() + 7));
+		ExpectTrue(static_cast<void *>(soa_.data<2>()) >= static_cast<void *>(soa_.data<1>() + 7));
+	} TestcaseEnd(columns_aligned);
+
+	Testcase(growth_keeps_rows)
+	{
+		auto soa_ = soa_t(size_t(0));
+		AssertTrue(push_rows(soa_, 0, 1000));
+		ExpectTrue(holds_rows(soa_, 1000));
+		ExpectEQ(uintptr_t(soa_.data<2>()) % soa_t::column_alignment, 0);
+		AssertTrue(soa_.reserve(5000));
+		ExpectEQ(soa_.capacity(), 5000);
+		ExpectTrue(holds_rows(soa_, 1000));
+		ExpectTrue(soa_.reserve(10));
+		ExpectEQ(soa_.capacity(), 5000);
+		for(int i = 0; i < 500; ++i)
+			AssertTrue(soa_.pop_back());
+		ExpectTrue(holds_rows(soa_, 500));
+	} TestcaseEnd(growth_keeps_rows);
+
+	Testcase(columns_and_rows)
+	{
+		auto soa_ = soa_t(size_t(0));
+		AssertTrue(push_rows(soa_, 0, 100));
+		auto ints_ = soa_.column<0>();
+		ExpectEQ(ints_.size(), 100);
+		long sum_ = 0;
+		for(int value_ : ints_)
+			sum_ += value_;
+		ExpectEQ(sum_, 4950);
+		for(auto & value_ : soa_.column<1>())
+			value_ *= 2;
+		auto row_ = soa_[10];
+		ExpectEQ(row_.index(), 10);
+		ExpectEQ(row_.at<0>(), 10);
+		ExpectEQ(row_.at<1>(), 10.0);
+		row_.at<2>() = 'z';
+		row_t const tuple_ = soa_.at(10).tuple();
+		ExpectEQ(tuple_.at<0>(), 10);
+		ExpectEQ(tuple_.at<2>(), 'z');
+		size_t rows_ = 0;
+		for(auto it = soa_.begin(); it != soa_.end(); ++it, ++rows_)
+			ExpectEQ((*it).at<0>(), int(rows_));
+		ExpectEQ(rows_, 100);
+		ExpectEQ(soa_.end() - soa_.begin(), 100);
+		ExpectThrow(soa_t::index_out_of_bounds const &, soa_.at(100));
+		soa_t const & const_ = soa_;
+		ExpectEQ(const_.column<0>()[99], 99);
+		ExpectEQ(const_[3].at<1>(), 3.0);
+	} TestcaseEnd(columns_and_rows);
+
+	Testcase(move_and_swap)
+	{
+		auto soa_ = soa_t(size_t(0));
+		AssertTrue(push_rows(soa_, 0, 40));
+		auto moved_ = soa_t(ds::move(soa_));
+		ExpectTrue(!soa_);
+		ExpectTrue(holds_rows(moved_, 40));
+		auto other_ = soa_t(size_t(0));
+		AssertTrue(push_rows(other_, 0, 3));
+		other_.swap(moved_);
+		ExpectTrue(holds_rows(other_, 40));
+		ExpectTrue(holds_rows(moved_, 3));
+		soa_ = ds::move(other_);
+		ExpectTrue(!other_);
+		ExpectTrue(holds_rows(soa_, 40));
+		soa_.clear();
+		ExpectTrue(bool(soa_));
+		ExpectEQ(soa_.size(), 0);
+	} TestcaseEnd(move_and_swap);
+
+	Testcase(non_trivial_fields)
+	{
+		{
+			auto soa_ = counter_soa_t(size_t(0));
+			for(int i = 0; i < 100; ++i)
+				AssertTrue(soa_.push_back(i, i));
+			ExpectEQ(Counter::active(), 100);
+			for(size_t i = 0; i < 100; ++i)
+				ExpectEQ(soa_.get<1>(i).value(), int(i));
+			AssertTrue(soa_.pop_back());
+			ExpectEQ(Counter::active(), 99);
+			soa_.clear();
+			ExpectEQ(Counter::active(), 0);
+			for(int i = 0; i < 20; ++i)
+				AssertTrue(soa_.push_back(i, i));
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(non_trivial_fields);
+
+};
+
+TestRegistry(soa_test)
+{
+	Register(null_soa)
+	Register(columns_aligned)
+	Register(growth_keeps_rows)
+	Register(columns_and_rows)
+	Register(move_and_swap)
+	Register(non_trivial_fields)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return soa_test().run_all(reporter_t<soa_test>(pptest::normal));
+}
@@ -0,0 +1,166 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/spsc_queue>
+#include <ds/thread>
+#include "../counter"
+
+template class ds::SpscQueue<int>;
+template class ds::SpscQueue<Counter>;
+
+using queue_t = ds::SpscQueue<int>;
+
+static constexpr int items_ = 200000;
+
+Test(spsc_queue_test)
+{
+	TestInit(spsc_queue_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(null_queue)
+	{
+		queue_t queue_;
+		ExpectTrue(!queue_);
+		ExpectEQ(queue_.capacity(), 0);
+		ExpectFalse(queue_.push(1));
+		ExpectNull(queue_.front());
+		ExpectFalse(queue_.pop());
+		int value_ = 0;
+		ExpectEQ(queue_.push_n(&value_, 1), 0);
+		ExpectEQ(queue_.pop_n(&value_, 1), 0);
+	} TestcaseEnd(null_queue);
+
+	Testcase(capacity_rounded_up)
+	{
+		queue_t queue_(5);
+		AssertTrue(bool(queue_));
+		ExpectEQ(queue_.capacity(), 8);
+		for(int i = 0; i < 8; ++i)
+			AssertTrue(queue_.push(i));
+		ExpectFalse(queue_.push(8));
+		ExpectEQ(queue_.size(), 8);
+		for(int i = 0; i < 8; ++i)
+		{
+			AssertNotNull(queue_.front());
+			ExpectEQ(*queue_.front(), i);
+			AssertTrue(queue_.pop());
+		}
+		ExpectTrue(queue_.empty());
+		ExpectFalse(queue_.pop());
+	} TestcaseEnd(capacity_rounded_up);
+
+	// spans are split where they wrap around the end of the buffer
+	Testcase(push_n_pop_n_wrap)
+	{
+		queue_t queue_(8);
+		int in_[8]  = { 0, 1, 2, 3, 4, 5, 6, 7 };
+		int out_[8] = {};
+		for(int round_ = 0; round_ < 8; ++round_)
+		{
+			AssertEQ(queue_.push_n(in_, 5), 5);
+			AssertEQ(queue_.pop_n(out_, 8), 5);
+			for(int i = 0; i < 5; ++i)
+				ExpectEQ(out_[i], i);
+		}
+		ExpectEQ(queue_.push_n(in_, 8), 8);
+		ExpectEQ(queue_.push_n(in_, 1), 0);
+		ExpectEQ(queue_.pop_n(out_, 3), 3);
+		ExpectEQ(queue_.push_n(in_, 8), 3);
+		ExpectEQ(queue_.pop_n(out_, 8), 8);
+		ExpectEQ(out_[0], 3);
+		ExpectEQ(out_[4], 7);
+		ExpectEQ(out_[5], 0);
+		ExpectEQ(out_[7], 2);
+	} TestcaseEnd(push_n_pop_n_wrap);
+
+	Testcase(destroy_destructs_queued)
+	{
+		{
+			ds::SpscQueue<Counter> queue_(4);
+			for(int i = 0; i < 4; ++i)
+				AssertTrue(queue_.push(i));
+			Counter popped_ { -1 };
+			AssertTrue(queue_.pop(popped_));
+			ExpectEQ(popped_.value(), 0);
+			ExpectEQ(Counter::active(), 4);
+			Counter out_[2] { Counter { -1 }, Counter { -1 } };
+			AssertEQ(queue_.pop_n(out_, 2), 2);
+			ExpectEQ(out_[0].value(), 1);
+			ExpectEQ(out_[1].value(), 2);
+			AssertEQ(queue_.push_n(out_, 2), 2);
+			ExpectEQ(queue_.size(), 3);
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(destroy_destructs_queued);
+
+	// a producer and a consumer thread exchange items_ values in order through a
+	//   small buffer, alternating single and batched calls
+	Testcase(producer_consumer_threads)
+	{
+		queue_t queue_(64);
+		{
+			auto producer_ = ds::Thread([&queue_]() {
+				int batch_[7];
+				for(int next_ = 0; next_ < items_; )
+				{
+					if(next_ % 2 == 0)
+					{
+						if(queue_.push(next_))
+							++next_;
+						else
+							ds::cpu_relax();
+						continue;
+					}
+					int const count_ = ds::min(7, items_ - next_);
+					for(int i = 0; i < count_; ++i)
+						batch_[i] = next_ + i;
+					size_t const pushed_ = queue_.push_n(batch_, size_t(count_));
+					if(pushed_ == 0)
+						ds::cpu_relax();
+					next_ += int(pushed_);
+				}
+			});
+			int  batch_[5];
+			int  expected_ = 0;
+			bool ordered_  = true;
+			while(expected_ < items_)
+			{
+				size_t popped_ = 0;
+				if(expected_ % 3 == 0)
+				{
+					if(queue_.pop(batch_[0]))
+						popped_ = 1;
+				}
+				else
+					popped_ = queue_.pop_n(batch_, 5);
+				if(popped_ == 0)
+					ds::cpu_relax();
+				for(size_t i = 0; i < popped_; ++i)
+					ordered_ = ordered_ && batch_[i] == expected_++;
+			}
+			ExpectTrue(ordered_);
+		}
+		ExpectTrue(queue_.empty());
+	} TestcaseEnd(producer_consumer_threads);
+
+};
+
+TestRegistry(spsc_queue_test)
+{
+	Register(null_queue)
+	Register(capacity_rounded_up)
+	Register(push_n_pop_n_wrap)
+	Register(destroy_destructs_queued)
+	Register(producer_consumer_threads)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return spsc_queue_test().run_all(reporter_t<spsc_queue_test>(pptest::normal));
+}
@@ -0,0 +1,210 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/stable_sort>
+#include <ds/array>
+#include "../counter"
+#include "../random"
+#include "../keyed"
+
+static size_t const sizes_[] { 0, 1, 2, 31, 32, 63, 64, 65, 1000, 4097, 100000 };
+
+using keyed_array_t = ds::Array<Keyed>;
+
+enum class Pattern
+{
+	random,
+	few_distinct,
+	sorted,
+	reversed,
+	all_equal,
+	descending_pairs,
+	runs,
+};
+
+static Pattern const patterns_[] {
+	Pattern::random,
+	Pattern::few_distinct,
+	Pattern::sorted,
+	Pattern::reversed,
+	Pattern::all_equal,
+	Pattern::descending_pairs,
+	Pattern::runs,
+};
+
+static keyed_array_t
+make_pattern(Pattern pattern_, size_t size_, uint32_t seed_ = 1)
+{
+	auto array_ = keyed_array_t(size_, Keyed {});
+	int const n = int(size_);
+	for(int i = 0; i < n; ++i)
+	{
+		int key_ = 0;
+		switch(pattern_)
+		{
+		case Pattern::random:           key_ = int(next_random(seed_) % size_); break;
+		case Pattern::few_distinct:     key_ = int(next_random(seed_) % 3); break;
+		case Pattern::sorted:           key_ = i; break;
+		case Pattern::reversed:         key_ = n - i; break;
+		case Pattern::all_equal:        key_ = 0; break;
+		// descending, but equal neighbours must not be swapped by a run reversal
+		case Pattern::descending_pairs: key_ = (n - i) / 2; break;
+		// ascending runs of random lengths
+		case Pattern::runs:             key_ = i % int(next_random(seed_) % 200 + 50); break;
+		}
+		array_[size_t(i)] = Keyed { key_, i };
+	}
+	return array_;
+}
+
+static bool
+is_sorted_stable(keyed_array_t const & array_)
+{
+	for(size_t i = 1; i < array_.size(); ++i)
+	{
+		Keyed const & lhs_ = array_[i - 1];
+		Keyed const & rhs_ = array_[i];
+		if(rhs_.key < lhs_.key || (rhs_.key == lhs_.key && rhs_.order < lhs_.order))
+			return false;
+	}
+	return true;
+}
+
+struct CountingLess
+{
+	size_t * calls;
+
+	inline bool
+	operator()(Keyed const & lhs_, Keyed const & rhs_) const noexcept
+	{
+		++*calls;
+		return lhs_.key < rhs_.key;
+	}
+};
+
+// no merge buffer, runs are merged in place
+struct NullAllocator
+{
+	static inline void * allocate(size_t, size_t = alignof(max_align_t)) noexcept { return nullptr; }
+	static inline void   deallocate(void *) noexcept {}
+};
+
+Test(stable_sort_test)
+{
+	TestInit(stable_sort_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(patterns_with_buffer)
+	{
+		for(Pattern pattern_ : patterns_)
+		{
+			for(size_t size_ : sizes_)
+			{
+				auto array_ = make_pattern(pattern_, size_);
+				ds::stable_sort(array_.begin(), array_.end());
+				ExpectTrue(is_sorted_stable(array_));
+				ExpectEQ(array_.size(), size_);
+			}
+		}
+	} TestcaseEnd(patterns_with_buffer);
+
+	Testcase(patterns_in_place)
+	{
+		for(Pattern pattern_ : patterns_)
+		{
+			for(size_t size_ : sizes_)
+			{
+				auto array_ = make_pattern(pattern_, size_, 3);
+				ds::stable_sort<NullAllocator>(array_.begin(), array_.end());
+				ExpectTrue(is_sorted_stable(array_));
+			}
+		}
+	} TestcaseEnd(patterns_in_place);
+
+	Testcase(comparisons_bounded)
+	{
+		size_t const size_ = 100000;
+		for(Pattern pattern_ : { Pattern::sorted, Pattern::reversed, Pattern::all_equal })
+		{
+			auto array_ = make_pattern(pattern_, size_);
+			size_t calls_ = 0;
+			ds::stable_sort(array_.begin(), array_.end(), CountingLess { &calls_ });
+			ExpectTrue(is_sorted_stable(array_));
+			ExpectTrue(calls_ < 2 * size_);
+		}
+		for(Pattern pattern_ : { Pattern::random, Pattern::few_distinct, Pattern::runs, Pattern::descending_pairs })
+		{
+			auto array_ = make_pattern(pattern_, size_);
+			size_t calls_ = 0;
+			ds::stable_sort(array_.begin(), array_.end(), CountingLess { &calls_ });
+			ExpectTrue(is_sorted_stable(array_));
+			ExpectTrue(calls_ <= 18 * size_);
+		}
+	} TestcaseEnd(comparisons_bounded);
+
+	Testcase(iterable_and_comparator)
+	{
+		auto array_ = ds::Array<int>({ 5, 3, 9, 1, 3, 7 });
+		ds::stable_sort(array_, ds::greater<int>());
+		int const expected_[] { 9, 7, 5, 3, 3, 1 };
+		for(size_t i = 0; i < 6; ++i)
+			ExpectEQ(array_[i], expected_[i]);
+	} TestcaseEnd(iterable_and_comparator);
+
+	Testcase(moves_no_copies)
+	{
+		{
+			uint32_t seed_ = 9;
+			auto counters_ = ds::Array<Counter>(size_t(5000), 0);
+			for(auto & counter_ : counters_)
+				counter_ = Counter(int(next_random(seed_) % 1000));
+			auto in_place_ = ds::Array<Counter>(counters_);
+			Counter::reset();
+			auto less_ = [](Counter const & lhs_, Counter const & rhs_) { return lhs_.value() < rhs_.value(); };
+			ds::stable_sort(counters_.begin(), counters_.end(), less_);
+			ds::stable_sort<NullAllocator>(in_place_.begin(), in_place_.end(), less_);
+			ExpectTrue(Counter::no_copies());
+			// elements moved to the buffer are destructed once moved back
+			ExpectEQ(Counter::active(), 0);
+			bool sorted_ = true;
+			for(size_t i = 1; i < counters_.size(); ++i)
+				sorted_ = sorted_ && counters_[i - 1].value() <= counters_[i].value() && in_place_[i - 1].value() <= in_place_[i].value();
+			ExpectTrue(sorted_);
+		}
+	} TestcaseEnd(moves_no_copies);
+
+	Testcase(owning_elements)
+	{
+		uint32_t seed_ = 21;
+		auto arrays_ = ds::Array<ds::Array<int>>(size_t(20000), [&seed_]() { return ds::Array<int>(size_t(2), int(next_random(seed_) % 100)); });
+		for(size_t i = 0; i < arrays_.size(); ++i)
+			arrays_[i][1] = int(i);
+		ds::stable_sort(arrays_, [](ds::Array<int> const & lhs_, ds::Array<int> const & rhs_) { return lhs_[0] < rhs_[0]; });
+		bool stable_ = true;
+		for(size_t i = 1; i < arrays_.size(); ++i)
+			stable_ = stable_ && (arrays_[i - 1][0] < arrays_[i][0] || (arrays_[i - 1][0] == arrays_[i][0] && arrays_[i - 1][1] < arrays_[i][1]));
+		ExpectTrue(stable_);
+	} TestcaseEnd(owning_elements);
+
+};
+
+TestRegistry(stable_sort_test)
+{
+	Register(patterns_with_buffer)
+	Register(patterns_in_place)
+	Register(comparisons_bounded)
+	Register(iterable_and_comparator)
+	Register(moves_no_copies)
+	Register(owning_elements)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return stable_sort_test().run_all(reporter_t<stable_sort_test>(pptest::normal));
+}
@@ -0,0 +1,154 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/stack>
+#include <ds/array>
+#include "../counter"
+
+template class ds::Stack<int>;
+template class ds::Stack<int,ds::allocators::NTMalloc>;
+
+// grows through A::reallocate
+using realloc_stack_t = ds::Stack<int,ds::allocators::NTMalloc>;
+
+Test(stack_test)
+{
+	TestInit(stack_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(relocatable_traits)
+	{
+		ExpectTrue(ds::is_trivially_relocatable<int>::value);
+		ExpectTrue(ds::is_trivially_relocatable<ds::Stack<int>>::value);
+		ExpectTrue(ds::is_trivially_relocatable<ds::Array<int>>::value);
+		ExpectFalse(ds::is_trivially_relocatable<Counter>::value);
+		ExpectTrue(ds::allocator_has_reallocate<ds::allocators::NTMalloc>::value);
+		ExpectFalse(ds::allocator_has_reallocate<ds::default_allocator>::value);
+	} TestcaseEnd(relocatable_traits);
+
+	Testcase(push_grows_default_allocator)
+	{
+		auto stack_ = ds::Stack<int>();
+		for(int i = 0; i < 1000; ++i)
+			AssertNotNull(stack_.push(i));
+		AssertEQ(stack_.size(), 1000);
+		ExpectTrue(stack_.capacity() >= 1000);
+		for(int i = 0; i < 1000; ++i)
+			ExpectEQ(stack_[size_t(i)], i);
+	} TestcaseEnd(push_grows_default_allocator);
+
+	Testcase(push_grows_through_reallocate)
+	{
+		auto stack_ = realloc_stack_t();
+		for(int i = 0; i < 100000; ++i)
+			AssertNotNull(stack_.push(i));
+		AssertEQ(stack_.size(), 100000);
+		bool same_ = true;
+		for(int i = 0; i < 100000; ++i)
+			same_ = same_ && stack_[size_t(i)] == i;
+		ExpectTrue(same_);
+		for(int i = 99999; i >= 50000; --i)
+		{
+			ExpectEQ(stack_.top(), i);
+			AssertTrue(stack_.pop());
+		}
+		AssertNotNull(stack_.push(-1));
+		ExpectEQ(stack_.size(), 50001);
+		ExpectEQ(stack_.top(), -1);
+	} TestcaseEnd(push_grows_through_reallocate);
+
+	// owning elements are relocated with memcpy, which must neither leak nor free twice
+	Testcase(relocatable_owning_elements)
+	{
+		auto stack_ = ds::Stack<ds::Array<int>,ds::allocators::NTMalloc>();
+		for(int i = 0; i < 200; ++i)
+			AssertNotNull(stack_.push(ds::Array<int>(size_t(i % 7 + 1), i)));
+		AssertEQ(stack_.size(), 200);
+		for(size_t i = 0; i < 200; ++i)
+		{
+			ExpectEQ(stack_[i].size(), i % 7 + 1);
+			ExpectEQ(stack_[i][0], int(i));
+		}
+		auto moved_ = ds::Stack<ds::Array<int>,ds::allocators::NTMalloc>(ds::move(stack_), 300);
+		ExpectTrue(!stack_);
+		ExpectEQ(moved_.size(), 200);
+		ExpectEQ(moved_[199][0], 199);
+	} TestcaseEnd(relocatable_owning_elements);
+
+	Testcase(non_relocatable_elements_are_moved)
+	{
+		{
+			auto stack_ = ds::Stack<Counter,ds::allocators::NTMalloc>();
+			for(int i = 0; i < 100; ++i)
+				AssertNotNull(stack_.push(i));
+			ExpectEQ(Counter::active(), 100);
+			ExpectTrue(Counter::moves() > 0);
+			for(size_t i = 0; i < 100; ++i)
+				ExpectEQ(stack_[i].value(), int(i));
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(non_relocatable_elements_are_moved);
+
+	Testcase(resizing_move_truncates)
+	{
+		auto stack_ = ds::Stack<int>({ 1, 2, 3, 4, 5 });
+		auto small_ = ds::Stack<int>(ds::move(stack_), 3);
+		ExpectTrue(!stack_);
+		ExpectEQ(small_.size(), 3);
+		ExpectEQ(small_.capacity(), 3);
+		ExpectEQ(small_.top(), 3);
+		{
+			auto counters_ = ds::Stack<Counter>(10);
+			for(int i = 0; i < 10; ++i)
+				AssertNotNull(counters_.push(i));
+			auto truncated_ = ds::Stack<Counter>(ds::move(counters_), 4);
+			ExpectEQ(truncated_.size(), 4);
+			ExpectEQ(Counter::active(), 4);
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(resizing_move_truncates);
+
+	Testcase(destroy_leaves_null_and_empty)
+	{
+		auto stack_ = ds::Stack<int>({ 1, 2, 3 });
+		stack_.destroy();
+		ExpectTrue(!stack_);
+		ExpectEQ(stack_.size(), 0);
+		ExpectEQ(stack_.capacity(), 0);
+		ExpectFalse(stack_.pop());
+		AssertNotNull(stack_.push(4));
+		ExpectEQ(stack_.size(), 1);
+		ExpectEQ(stack_.top(), 4);
+		{
+			auto counters_ = ds::Stack<Counter>(4);
+			for(int i = 0; i < 4; ++i)
+				AssertNotNull(counters_.push(i));
+			counters_.destroy();
+			ExpectEQ(counters_.size(), 0);
+			ExpectEQ(Counter::active(), 0);
+		}
+	} TestcaseEnd(destroy_leaves_null_and_empty);
+
+};
+
+TestRegistry(stack_test)
+{
+	Register(relocatable_traits)
+	Register(push_grows_default_allocator)
+	Register(push_grows_through_reallocate)
+	Register(relocatable_owning_elements)
+	Register(non_relocatable_elements_are_moved)
+	Register(resizing_move_truncates)
+	Register(destroy_leaves_null_and_empty)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return stack_test().run_all(reporter_t<stack_test>(pptest::normal));
+}
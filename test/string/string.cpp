@@ -0,0 +1,478 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/string>
+
+template class ds::String<>;
+
+// fails every allocation while failing is set
+struct FailingAllocator
+{
+	static bool failing;
+
+	static void *
+	allocate(size_t size_, ds::align_t align_) noexcept
+	{
+		return failing ? nullptr : ds::default_nt_allocator::allocate(size_, align_);
+	}
+
+	static void
+	deallocate(void * block_) noexcept
+	{
+		ds::default_nt_allocator::deallocate(block_);
+	}
+
+};
+
+bool FailingAllocator::failing = false;
+
+// counts the blocks allocated, to tell inline strings from heap ones
+struct CountingAllocator
+{
+	static size_t allocations;
+
+	static void *
+	allocate(size_t size_, ds::align_t align_) noexcept
+	{
+		++allocations;
+		return ds::default_nt_allocator::allocate(size_, align_);
+	}
+
+	static void
+	deallocate(void * block_) noexcept
+	{
+		ds::default_nt_allocator::deallocate(block_);
+	}
+
+};
+
+size_t CountingAllocator::allocations = 0;
+
+using counted_string_t = ds::String<CountingAllocator>;
+
+static char const letters_[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+
+// the searches as sequential loops, npos when nothing is found
+static size_t
+brute_find(ds::StringView view_, ds::StringView needle_, size_t from_)
+{
+	for(size_t i = from_; i + needle_.size() <= view_.size(); ++i)
+		if(memcmp(view_.begin() + i, needle_.begin(), needle_.size()) == 0)
+			return i;
+	return ds::StringView::npos;
+}
+
+static size_t
+brute_rfind(ds::StringView view_, ds::StringView needle_)
+{
+	if(needle_.size() == 0)
+		return view_.size();
+	for(size_t i = view_.size() + 1; i-- > needle_.size();)
+		if(memcmp(view_.begin() + i - needle_.size(), needle_.begin(), needle_.size()) == 0)
+			return i - needle_.size();
+	return ds::StringView::npos;
+}
+
+// size_ chars, terminated, the view and the array on the same chars
+template <class S>
+static bool
+holds_letters(S const & string_, size_t size_)
+{
+	if(!string_ || string_.size() != size_ || string_.capacity() < size_ || string_.begin()[size_] != '\0')
+		return false;
+	if(string_.view().begin() != string_.begin() || string_.view().size() != size_ || &string_.array()[0] != string_.begin())
+		return false;
+	for(size_t i = 0; i < size_; ++i)
+		if(string_[i] != letters_[i])
+			return false;
+	return true;
+}
+
+Test(string_test)
+{
+	TestInit(string_test);
+
+	PreRun()
+	{
+		FailingAllocator::failing      = false;
+		CountingAllocator::allocations = 0;
+	}
+
+	// up to inline_capacity chars live in the object, one more goes to the heap
+	Testcase(inline_boundary)
+	{
+		ExpectEQ(ds::String<>::inline_capacity, 3 * sizeof(size_t) - 2);
+		ExpectEQ(sizeof(ds::String<>), 3 * sizeof(size_t));
+		size_t const inline_ = counted_string_t::inline_capacity;
+		for(size_t size_ : { size_t(0), size_t(1), inline_ - 1, inline_, inline_ + 1, inline_ + 2, size_t(35) })
+		{
+			bool const heap_ = size_ > inline_;
+			CountingAllocator::allocations = 0;
+			auto const pointer_ = counted_string_t(letters_, size_);
+			auto const range_   = counted_string_t(letters_, letters_ + size_);
+			auto const view_    = counted_string_t(ds::StringView(letters_, size_));
+			auto const copy_    = counted_string_t(pointer_);
+			ExpectEQ(CountingAllocator::allocations, heap_ ? 4 : 0);
+			ExpectTrue(holds_letters(pointer_, size_));
+			ExpectTrue(holds_letters(range_, size_));
+			ExpectTrue(holds_letters(view_, size_));
+			ExpectTrue(holds_letters(copy_, size_));
+			ExpectEQ(pointer_.capacity(), heap_ ? size_ : inline_);
+			// an inline string points into the object itself
+			bool const inside_ = pointer_.begin() >= reinterpret_cast<char const *>(&pointer_)
+				&& pointer_.begin() < reinterpret_cast<char const *>(&pointer_ + 1);
+			ExpectEQ(inside_, !heap_);
+			auto const filled_ = counted_string_t(size_, 'q');
+			ExpectEQ(filled_.size(), size_);
+			ExpectEQ(filled_.begin()[size_], '\0');
+			ExpectEQ(filled_.count('q'), size_);
+		}
+	} TestcaseEnd(inline_boundary);
+
+	Testcase(grow_past_inline_and_back)
+	{
+		size_t const inline_ = counted_string_t::inline_capacity;
+		auto string_ = counted_string_t();
+		ExpectTrue(holds_letters(string_, 0));
+		for(size_t i = 0; i < inline_; ++i)
+			AssertTrue(string_.push_back(letters_[i]));
+		ExpectEQ(CountingAllocator::allocations, 0);
+		ExpectTrue(holds_letters(string_, inline_));
+		AssertTrue(string_.push_back(letters_[inline_]));
+		ExpectEQ(CountingAllocator::allocations, 1);
+		ExpectTrue(holds_letters(string_, inline_ + 1));
+		AssertTrue(string_.resize_uninitialized(inline_));
+		AssertTrue(string_.shrink_to_fit());
+		ExpectEQ(string_.capacity(), inline_);
+		ExpectTrue(holds_letters(string_, inline_));
+		// reserving within the inline capacity never allocates
+		AssertTrue(string_.reserve(inline_));
+		ExpectEQ(CountingAllocator::allocations, 1);
+		AssertTrue(string_.reserve(inline_ + 1));
+		ExpectEQ(CountingAllocator::allocations, 2);
+		ExpectTrue(holds_letters(string_, inline_));
+	} TestcaseEnd(grow_past_inline_and_back);
+
+	Testcase(copy_move_swap_representations)
+	{
+		size_t const inline_ = counted_string_t::inline_capacity;
+		auto short_ = counted_string_t(letters_, inline_);
+		auto long_  = counted_string_t(letters_, inline_ + 1);
+		short_.swap(long_);
+		ExpectTrue(holds_letters(short_, inline_ + 1));
+		ExpectTrue(holds_letters(long_, inline_));
+		auto moved_ = counted_string_t(ds::move(long_));
+		ExpectTrue(!long_);
+		ExpectTrue(holds_letters(moved_, inline_));
+		auto truncated_ = counted_string_t(ds::move(short_), 3);
+		ExpectTrue(!short_);
+		ExpectTrue(holds_letters(truncated_, 3));
+		auto inline_truncated_ = counted_string_t(ds::move(moved_), 5);
+		ExpectTrue(holds_letters(inline_truncated_, 5));
+		// copy assignment across both representations
+		auto target_ = counted_string_t(letters_, 30);
+		target_ = inline_truncated_;
+		ExpectTrue(holds_letters(target_, 5));
+		target_ = counted_string_t(letters_, 30);
+		ExpectTrue(holds_letters(target_, 30));
+		target_ = counted_string_t(letters_, 2);
+		ExpectTrue(holds_letters(target_, 2));
+		auto const & self_ = target_;
+		target_ = self_;
+		ExpectTrue(holds_letters(target_, 2));
+	} TestcaseEnd(copy_move_swap_representations);
+
+	Testcase(null_string)
+	{
+		auto null_ = ds::String<>(ds::noinit);
+		ExpectTrue(!null_);
+		ExpectEQ(null_.size(), 0);
+		ExpectEQ(null_.capacity(), 0);
+		ExpectNull(null_.begin());
+		ExpectNull(null_.end());
+		ExpectEQ(null_.length(), 0);
+		ExpectEQ(null_.view().size(), 0);
+		ExpectFalse(null_ == "");
+		ExpectEQ(null_.compare("abc"), -2);
+		ExpectThrow(ds::String<>::null_pointer const &, null_.at(0));
+		auto copy_ = ds::String<>(null_);
+		ExpectTrue(!copy_);
+		auto moved_ = ds::String<>(ds::move(copy_));
+		ExpectTrue(!moved_);
+		// an inline string destroyed becomes null, and stays so when destroyed again
+		auto inline_ = ds::String<>("abc");
+		inline_.destroy();
+		ExpectTrue(!inline_);
+		ExpectEQ(inline_.size(), 0);
+		inline_.destroy();
+		ExpectTrue(!inline_);
+		auto other_ = ds::String<>("xyz");
+		other_.swap(null_);
+		ExpectTrue(!other_);
+		ExpectTrue(null_ == "xyz");
+		other_ = null_;
+		ExpectTrue(other_ == "xyz");
+		null_ = ds::String<>(ds::noinit);
+		ExpectTrue(!null_);
+	} TestcaseEnd(null_string);
+
+	// the vectorized searches of StringView and String at every offset into a string,
+	//   against the same searches as sequential loops
+	Testcase(searches_at_offsets)
+	{
+		auto string_ = ds::String<>();
+		uint32_t seed_ = 1;
+		for(size_t i = 0; i < 300; ++i)
+		{
+			seed_ = seed_ * 1664525u + 1013904223u;
+			AssertTrue(string_.push_back("abca\x80"[(seed_ >> 8) % 5]));
+		}
+		char const * const needles_[] { "", "a", "ab", "aab", "abca", "\x80" "a", "cab\x80", "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb" };
+		for(size_t offset_ = 0; offset_ < 19; ++offset_)
+		{
+			for(size_t size_ : { size_t(0), size_t(1), size_t(15), size_t(16), size_t(17), size_t(33), size_t(64), size_t(200) })
+			{
+				ds::StringView const view_ = string_.view(offset_, size_);
+				auto const copy_ = ds::String<>(view_);
+				for(char char_ : { 'a', 'c', '\x80', 'z' })
+				{
+					size_t first_ = ds::StringView::npos, second_ = ds::StringView::npos, last_ = ds::StringView::npos, count_ = 0;
+					for(size_t i = 0; i < size_; ++i)
+					{
+						if(view_[i] != char_)
+							continue;
+						second_ = count_ == 1 ? i : second_;
+						first_  = count_ == 0 ? i : first_;
+						last_   = i;
+						++count_;
+					}
+					AssertEQ(view_.find(char_), first_);
+					AssertEQ(view_.rfind(char_), last_);
+					AssertEQ(view_.count(char_), count_);
+					AssertEQ(copy_.find(char_), first_);
+					AssertEQ(copy_.rfind(char_), last_);
+					AssertEQ(copy_.count(char_), count_);
+					if(first_ != ds::StringView::npos)
+						AssertEQ(view_.find(char_, first_ + 1), second_);
+					AssertEQ(view_.find(char_, size_), ds::StringView::npos);
+				}
+				for(char const * pneedle_ : needles_)
+				{
+					auto const needle_ = ds::StringView(pneedle_, ds::string_length(pneedle_));
+					for(size_t from_ : { size_t(0), size_t(1), size_ / 2, size_ })
+					{
+						AssertEQ(view_.find(needle_, from_), brute_find(view_, needle_, from_));
+						AssertEQ(copy_.find(needle_, from_), brute_find(view_, needle_, from_));
+					}
+					AssertEQ(view_.find(needle_, size_ + 1), ds::StringView::npos);
+					AssertEQ(view_.rfind(needle_), brute_rfind(view_, needle_));
+					AssertEQ(copy_.rfind(needle_), brute_rfind(view_, needle_));
+				}
+				// the same chars at another offset and in another allocation
+				ds::StringView const other_ = copy_.view();
+				AssertTrue(view_.equals(other_));
+				AssertTrue(copy_.equals(view_));
+				AssertEQ(view_.compare(other_), 0);
+				AssertEQ(copy_.compare(view_), 0);
+				if(size_ > 0)
+				{
+					AssertFalse(view_.equals(copy_.view(size_ - 1)));
+					AssertEQ(copy_.view(size_ - 1).compare(view_), -1);
+					AssertEQ(view_.compare(copy_.view(size_ - 1)), 1);
+				}
+			}
+		}
+	} TestcaseEnd(searches_at_offsets);
+
+	Testcase(null_string_append_nothing)
+	{
+		auto string_ = ds::String<>(ds::noinit);
+		AssertTrue(!string_);
+		AssertTrue(string_.append("", 0));
+		AssertTrue(bool(string_));
+		ExpectEQ(string_.size(), 0);
+		ExpectEQ(string_.begin()[0], '\0');
+	} TestcaseEnd(null_string_append_nothing);
+
+	Testcase(destroyed_string_grows_from_nothing)
+	{
+		auto string_ = ds::String<>("abc");
+		string_.destroy();
+		AssertTrue(string_.resize_uninitialized(0));
+		ExpectEQ(string_.size(), 0);
+		ExpectEQ(string_.begin()[0], '\0');
+		string_.destroy();
+		string_ += "";
+		AssertTrue(bool(string_));
+		ExpectEQ(string_.size(), 0);
+		string_.destroy();
+		AssertTrue(string_.push_back('x'));
+		ExpectTrue(string_ == "x");
+		string_.destroy();
+		ExpectTrue(string_.reserve(0));
+		ExpectTrue(string_.shrink_to_fit());
+		ExpectEQ(string_.size(), 0);
+		ExpectEQ(string_.begin()[0], '\0');
+	} TestcaseEnd(destroyed_string_grows_from_nothing);
+
+	Testcase(append_grows_geometrically)
+	{
+		auto string_ = ds::String<>();
+		size_t resizes_  = 0;
+		size_t capacity_ = string_.capacity();
+		for(int i = 0; i < 10000; ++i)
+		{
+			AssertTrue(string_.append("0123456789", 10));
+			AssertTrue(string_.capacity() >= string_.size());
+			if(string_.capacity() != capacity_)
+			{
+				capacity_ = string_.capacity();
+				++resizes_;
+			}
+		}
+		ExpectEQ(string_.size(), 100000);
+		ExpectLT(resizes_, 40);
+		ExpectEQ(string_.begin()[string_.size()], '\0');
+		for(size_t i = 0; i < string_.size(); ++i)
+			AssertEQ(string_[i], char('0' + i % 10));
+	} TestcaseEnd(append_grows_geometrically);
+
+	Testcase(append_from_itself)
+	{
+		auto string_ = ds::String<>("ab");
+		for(int i = 0; i < 6; ++i)
+			AssertTrue(string_.append(string_.begin(), string_.size()));
+		AssertEQ(string_.size(), 128);
+		for(size_t i = 0; i < string_.size(); ++i)
+			AssertEQ(string_[i], i % 2 == 0 ? 'a' : 'b');
+		string_ += string_;
+		ExpectEQ(string_.size(), 256);
+	} TestcaseEnd(append_from_itself);
+
+	Testcase(push_back_and_operators)
+	{
+		auto string_ = ds::String<>("hello");
+		string_ += ' ';
+		string_ += "world";
+		string_ += ds::StringView("!");
+		ExpectTrue(string_ == "hello world!");
+		for(int i = 0; i < 40; ++i)
+			AssertTrue(string_.push_back('x'));
+		ExpectEQ(string_.size(), 52);
+		ExpectEQ(string_.begin()[52], '\0');
+	} TestcaseEnd(push_back_and_operators);
+
+	Testcase(reserve_resize_and_shrink)
+	{
+		auto string_ = ds::String<>("hello");
+		AssertTrue(string_.reserve(100));
+		ExpectEQ(string_.capacity(), 100);
+		ExpectTrue(string_ == "hello");
+		AssertTrue(string_.resize_uninitialized(50));
+		for(size_t i = 5; i < 50; ++i)
+			string_[i] = 'z';
+		ExpectEQ(string_.size(), 50);
+		ExpectEQ(string_.begin()[50], '\0');
+		AssertTrue(string_.shrink_to_fit());
+		ExpectEQ(string_.capacity(), 50);
+		AssertTrue(string_.resize_uninitialized(5));
+		AssertTrue(string_.shrink_to_fit());
+		ExpectEQ(string_.capacity(), ds::String<>::inline_capacity);
+		ExpectTrue(string_ == "hello");
+	} TestcaseEnd(reserve_resize_and_shrink);
+
+	// appending a char at a time allocates O(log n) times, not once per append
+	Testcase(append_amortized_allocations)
+	{
+		auto string_ = counted_string_t();
+		for(size_t i = 0; i < 100000; ++i)
+			AssertTrue(string_.push_back(letters_[i % 36]));
+		ExpectLT(CountingAllocator::allocations, 40);
+		CountingAllocator::allocations = 0;
+		auto fragments_ = counted_string_t();
+		size_t size_ = 0;
+		for(size_t i = 0; i < 10000; ++i)
+		{
+			AssertTrue(fragments_.append(letters_, i % 36));
+			size_ += i % 36;
+		}
+		ExpectLT(CountingAllocator::allocations, 40);
+		ExpectEQ(fragments_.size(), size_);
+		// a larger scale grows in fewer steps
+		counted_string_t::capacity_scale_nominator   = 1;
+		counted_string_t::capacity_scale_denominator = 1;
+		CountingAllocator::allocations = 0;
+		auto doubled_ = counted_string_t();
+		for(size_t i = 0; i < 100000; ++i)
+			AssertTrue(doubled_.push_back('d'));
+		ExpectLT(CountingAllocator::allocations, 20);
+		counted_string_t::capacity_scale_denominator = 2;
+	} TestcaseEnd(append_amortized_allocations);
+
+	// growing through reallocate() keeps the chars, also when appending a part of the string itself
+	Testcase(append_through_reallocate)
+	{
+		using realloc_string_t = ds::String<ds::allocators::NTMalloc>;
+		ExpectTrue(ds::allocator_has_reallocate<ds::allocators::NTMalloc>::value);
+		auto string_ = realloc_string_t(letters_, 10);
+		for(int i = 0; i < 12; ++i)
+			AssertTrue(string_.append(string_.begin() + 5, string_.size() - 5));
+		size_t expected_ = 10;
+		for(int i = 0; i < 12; ++i)
+			expected_ += expected_ - 5;
+		ExpectEQ(string_.size(), expected_);
+		ExpectEQ(string_.begin()[expected_], '\0');
+		bool same_ = true;
+		for(size_t i = 0; i < 5; ++i)
+			same_ = same_ && string_[i] == letters_[i];
+		for(size_t i = 5; i < expected_; ++i)
+			same_ = same_ && string_[i] == letters_[5 + (i - 5) % 5];
+		ExpectTrue(same_);
+		// appending the inline chars of a string that moves to the heap
+		auto inline_ = realloc_string_t(letters_, 20);
+		AssertTrue(inline_.append(inline_.view()));
+		ExpectEQ(inline_.size(), 40);
+		for(size_t i = 0; i < 40; ++i)
+			AssertEQ(inline_[i], letters_[i % 20]);
+	} TestcaseEnd(append_through_reallocate);
+
+	Testcase(failed_growth_leaves_string)
+	{
+		auto string_ = ds::String<FailingAllocator>("0123456789012345678901234567");
+		FailingAllocator::failing = true;
+		ExpectFalse(string_.append("abc", 3));
+		string_ += "abc";
+		ExpectFalse(string_.push_back('x'));
+		ExpectFalse(string_.reserve(1000));
+		ExpectTrue(string_ == "0123456789012345678901234567");
+		FailingAllocator::failing = false;
+		ExpectTrue(string_.append("abc", 3));
+		ExpectEQ(string_.size(), 31);
+	} TestcaseEnd(failed_growth_leaves_string);
+
+};
+
+TestRegistry(string_test)
+{
+	Register(inline_boundary)
+	Register(grow_past_inline_and_back)
+	Register(copy_move_swap_representations)
+	Register(null_string)
+	Register(searches_at_offsets)
+	Register(null_string_append_nothing)
+	Register(destroyed_string_grows_from_nothing)
+	Register(append_grows_geometrically)
+	Register(append_from_itself)
+	Register(push_back_and_operators)
+	Register(reserve_resize_and_shrink)
+	Register(append_amortized_allocations)
+	Register(append_through_reallocate)
+	Register(failed_growth_leaves_string)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return string_test().run_all(reporter_t<string_test>(pptest::normal));
+}
@@ -0,0 +1,216 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/string_split>
+#include <ds/string>
+#include <ds/stack>
+#include "../random"
+
+using view_t   = ds::StringView;
+using fields_t = ds::Stack<view_t>;
+
+template class ds::StringSplit<ds::_::_split_char>;
+template class ds::StringSplit<ds::_::_split_any>;
+template class ds::StringSplit<ds::_::_split_string>;
+template class ds::StringSplit<ds::_::_split_line>;
+
+static view_t
+view_of(char const * string_) noexcept
+{
+	return { string_, ds::string_length(string_) };
+}
+
+// size_ chars of the alphabet, the delimiters being more or less frequent
+static ds::String<>
+make_text(size_t size_, char const * alphabet_, uint32_t seed_)
+{
+	size_t const letters_ = ds::string_length(alphabet_);
+	auto string_ = ds::String<>();
+	for(size_t i = 0; i < size_; ++i)
+		string_.push_back(alphabet_[next_random(seed_) % letters_]);
+	return string_;
+}
+
+// the fields as a sequential loop would find them, is_delimiter_ giving the length of
+//   a delimiter at an index or 0
+template <class F>
+static fields_t
+brute_fields(view_t string_, F && is_delimiter_, bool skip_empty_ = false)
+{
+	auto fields_ = fields_t(size_t(0));
+	size_t start_ = 0;
+	for(size_t i = 0; i < string_.size();)
+	{
+		size_t const length_ = is_delimiter_(i);
+		if(length_ == 0)
+		{
+			++i;
+			continue;
+		}
+		if(!skip_empty_ || i > start_)
+			fields_.push(string_.begin() + start_, i - start_);
+		i += length_;
+		start_ = i;
+	}
+	if(!skip_empty_ || string_.size() > start_)
+		fields_.push(string_.begin() + start_, string_.size() - start_);
+	return fields_;
+}
+
+// the same fields, and views into the string rather than copies
+template <class S>
+static bool
+same_fields(S const & split_, fields_t const & expected_)
+{
+	size_t i = 0;
+	for(view_t field_ : split_)
+	{
+		if(i >= expected_.size() || field_.begin() != expected_[i].begin() || field_.size() != expected_[i].size())
+			return false;
+		++i;
+	}
+	return i == expected_.size() && split_.count() == expected_.size();
+}
+
+template <class S, size_t N>
+static bool
+same_fields(S const & split_, char const * const (&expected_)[N])
+{
+	auto it = split_.begin();
+	for(char const * field_ : expected_)
+	{
+		if(!it || !(*it).equals(view_of(field_)))
+			return false;
+		++it;
+	}
+	return !it && split_.count() == N;
+}
+
+Test(string_split_test)
+{
+	TestInit(string_split_test);
+
+	Testcase(split_char)
+	{
+		ExpectTrue(same_fields(ds::split(view_of("a,b,,c"), ','), { "a", "b", "", "c" }));
+		ExpectTrue(same_fields(ds::split(view_of("abc"), ','), { "abc" }));
+		// n delimiters, n + 1 fields
+		ExpectTrue(same_fields(ds::split(view_of(""), ','), { "" }));
+		ExpectTrue(same_fields(ds::split(view_of(","), ','), { "", "" }));
+		ExpectTrue(same_fields(ds::split(view_of(",a,"), ','), { "", "a", "" }));
+	} TestcaseEnd(split_char);
+
+	Testcase(split_string)
+	{
+		ExpectTrue(same_fields(ds::split(view_of("a::b::::c"), view_of("::")), { "a", "b", "", "c" }));
+		// occurrences do not overlap
+		ExpectTrue(same_fields(ds::split(view_of("a;;;b"), view_of(";;")), { "a", ";b" }));
+		ExpectTrue(same_fields(ds::split(view_of("a::"), view_of("::")), { "a", "" }));
+		ExpectTrue(same_fields(ds::split(view_of("a:b"), view_of("::")), { "a:b" }));
+		// an empty delimiter never occurs
+		ExpectTrue(same_fields(ds::split(view_of("a:b"), view_of("")), { "a:b" }));
+		ExpectTrue(same_fields(ds::split(view_of(""), view_of("")), { "" }));
+	} TestcaseEnd(split_string);
+
+	Testcase(split_any_and_tokenize)
+	{
+		ExpectTrue(same_fields(ds::split_any(view_of("a,b;c,;d"), view_of(",;")), { "a", "b", "c", "", "d" }));
+		ExpectTrue(same_fields(ds::split_any(view_of("a,b"), view_of("")), { "a,b" }));
+		ExpectTrue(same_fields(ds::tokenize(view_of("  one\ttwo \r\n three\v\f")), { "one", "two", "three" }));
+		ExpectTrue(same_fields(ds::tokenize(view_of("a--b-c-"), view_of("-")), { "a", "b", "c" }));
+		ExpectTrue(!ds::tokenize(view_of("")).begin());
+		ExpectTrue(!ds::tokenize(view_of(" \t\n ")).begin());
+	} TestcaseEnd(split_any_and_tokenize);
+
+	// no empty line after the last line ending, "\r" only dropped right before "\n"
+	Testcase(lines)
+	{
+		ExpectTrue(same_fields(ds::lines(view_of("a\r\nb\n\nc")), { "a", "b", "", "c" }));
+		ExpectTrue(same_fields(ds::lines(view_of("a\nb\n")), { "a", "b" }));
+		ExpectTrue(same_fields(ds::lines(view_of("a\n\n")), { "a", "" }));
+		ExpectTrue(same_fields(ds::lines(view_of("\n")), { "" }));
+		ExpectTrue(same_fields(ds::lines(view_of("\r\n")), { "" }));
+		ExpectTrue(same_fields(ds::lines(view_of("a\rb\r")), { "a\rb\r" }));
+		ExpectTrue(same_fields(ds::lines(view_of("a\r\nb\r")), { "a", "b\r" }));
+		ExpectTrue(!ds::lines(view_of("")).begin());
+	} TestcaseEnd(lines);
+
+	Testcase(iterators)
+	{
+		auto const string_ = view_of("ab,c,def");
+		auto const split_ = ds::split(string_, ',');
+		ExpectEQ(split_.string().begin(), string_.begin());
+		auto it = split_.begin();
+		ExpectTrue(it == split_.begin());
+		ExpectTrue(it != split_.end());
+		ExpectTrue((*it).equals(view_of("ab")));
+		ExpectTrue(it.rest().equals(view_of("c,def")));
+		auto const previous_ = it++;
+		ExpectTrue((*previous_).equals(view_of("ab")));
+		ExpectTrue((*it).equals(view_of("c")));
+		ExpectTrue(it != previous_);
+		ExpectTrue((*++it).equals(view_of("def")));
+		ExpectEQ(it.rest().size(), 0);
+		ExpectTrue(bool(it));
+		++it;
+		ExpectTrue(!it);
+		ExpectTrue(it == split_.end());
+		// past the end stays at the end
+		++it;
+		ExpectTrue(it == split_.end());
+		// the ends of different splits are the same
+		ExpectTrue(ds::split(view_of("x"), ',').end() == split_.end());
+		ExpectTrue(ds::split(view_of("x"), ',').begin() != split_.begin());
+	} TestcaseEnd(iterators);
+
+	// long strings go through the vectorized searches, delimiters at every offset
+	Testcase(random_texts)
+	{
+		for(size_t size_ : { size_t(1), size_t(15), size_t(16), size_t(17), size_t(63), size_t(1000) })
+		{
+			for(char const * alphabet_ : { "abcdefghijklmnopqrstuvwxyz,", "a,", "ab;,\r\n", "abcdefghijklmnopqrstuvwxyz0123456789 \n" })
+			{
+				auto const text_ = make_text(size_, alphabet_, uint32_t(size_) * 7 + 1);
+				view_t const view_ = text_.view();
+				char const * const begin_ = view_.begin();
+				auto const is_char_ = [begin_](size_t i) -> size_t { return begin_[i] == ','; };
+				auto const is_any_  = [begin_](size_t i) -> size_t { return begin_[i] == ',' || begin_[i] == ';'; };
+				auto const is_space_ = [begin_](size_t i) -> size_t { return begin_[i] == ' ' || begin_[i] == '\n' || begin_[i] == '\r'; };
+				auto const is_string_ = [begin_, &view_](size_t i) -> size_t {
+					return i + 1 < view_.size() && begin_[i] == 'a' && begin_[i + 1] == ',' ? 2 : 0;
+				};
+				ExpectTrue(same_fields(ds::split(view_, ','), brute_fields(view_, is_char_)));
+				ExpectTrue(same_fields(ds::split_any(view_, view_of(",;")), brute_fields(view_, is_any_)));
+				ExpectTrue(same_fields(ds::split(view_, view_of("a,")), brute_fields(view_, is_string_)));
+				ExpectTrue(same_fields(ds::tokenize(view_, view_of(" \n\r")), brute_fields(view_, is_space_, true)));
+				// lines, as fields between "\n" without the empty last one, and without
+				//   a trailing "\r" unless nothing follows them
+				auto lines_ = brute_fields(view_, [begin_](size_t i) -> size_t { return begin_[i] == '\n'; });
+				if(lines_[lines_.size() - 1].size() == 0)
+					lines_.pop();
+				for(auto & line_ : lines_)
+					if(line_.size() > 0 && line_[line_.size() - 1] == '\r' && line_.end() < view_.end())
+						line_ = view_t(line_.begin(), line_.size() - 1);
+				ExpectTrue(same_fields(ds::lines(view_), lines_));
+			}
+		}
+	} TestcaseEnd(random_texts);
+
+};
+
+TestRegistry(string_split_test)
+{
+	Register(split_char)
+	Register(split_string)
+	Register(split_any_and_tokenize)
+	Register(lines)
+	Register(iterators)
+	Register(random_texts)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return string_split_test().run_all(reporter_t<string_split_test>(pptest::normal));
+}
@@ -0,0 +1,160 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/thread_pool>
+#include <ds/thread>
+
+template class ds::ThreadPool<>;
+template class ds::PoolTask<int>;
+
+using pool_t = ds::ThreadPool<>;
+
+static constexpr int submitters_    = 4;
+static constexpr int per_submitter_ = 5000;
+
+// sums [begin_,end_) by splitting it into tasks, waiting on them from the workers
+static long
+split_sum(pool_t & pool_, int begin_, int end_)
+{
+	if(end_ - begin_ <= 16)
+	{
+		long sum_ = 0;
+		for(int i = begin_; i < end_; ++i)
+			sum_ += i;
+		return sum_;
+	}
+	int const middle_ = begin_ + (end_ - begin_) / 2;
+	auto left_ = pool_.submit([&pool_, begin_, middle_]() { return split_sum(pool_, begin_, middle_); });
+	long const right_ = split_sum(pool_, middle_, end_);
+	pool_.wait(left_);
+	return left_.get() + right_;
+}
+
+Test(thread_pool_test)
+{
+	TestInit(thread_pool_test);
+
+	Testcase(null_pool)
+	{
+		pool_t pool_;
+		ExpectTrue(!pool_);
+		ExpectEQ(pool_.size(), 0);
+		ExpectTrue(!pool_.submit([]() { return 1; }));
+		ExpectFalse(pool_.run_one());
+	} TestcaseEnd(null_pool);
+
+	Testcase(submit_returns_results)
+	{
+		pool_t pool_(2);
+		AssertTrue(bool(pool_));
+		ExpectEQ(pool_.size(), 2);
+		ExpectFalse(pool_.is_worker());
+		int  ran_  = 0;
+		auto int_  = pool_.submit([]() { return 42; });
+		auto void_ = pool_.submit([&ran_]() { ran_ = 1; });
+		auto self_ = pool_.submit([&pool_]() { return pool_.is_worker(); });
+		AssertTrue(bool(int_));
+		pool_.wait(int_);
+		ExpectTrue(int_.ready());
+		ExpectEQ(int_.get(), 42);
+		void_.wait();
+		ExpectEQ(ran_, 1);
+		ExpectTrue(self_.get());
+	} TestcaseEnd(submit_returns_results);
+
+	// the global queue is much smaller than the number of tasks, the submitter blocks on it
+	Testcase(overflow_global_queue)
+	{
+		ds::Atomic<int> done_ { 0 };
+		pool_t pool_(3, false, 16);
+		for(int i = 0; i < 10000; ++i)
+			AssertTrue(bool(pool_.submit([&done_]() { done_.fetch_add(1, ds::memory_order::relaxed); })));
+		pool_.wait_idle();
+		ExpectEQ(done_.load(), 10000);
+	} TestcaseEnd(overflow_global_queue);
+
+	Testcase(concurrent_submitters)
+	{
+		ds::Atomic<long> sum_ { 0 };
+		pool_t pool_(4);
+		ds::Thread * threads_[submitters_];
+		for(int t = 0; t < submitters_; ++t)
+		{
+			threads_[t] = new ds::Thread([&pool_, &sum_, t]() {
+				for(int i = 0; i < per_submitter_; ++i)
+				{
+					long const value_ = t * per_submitter_ + i;
+					pool_.submit([&sum_, value_]() { sum_.fetch_add(value_, ds::memory_order::relaxed); });
+				}
+			});
+		}
+		for(auto thread_ : threads_)
+			delete thread_;
+		pool_.wait_idle();
+		long const count_ = submitters_ * per_submitter_;
+		ExpectEQ(sum_.load(), count_ * (count_ - 1) / 2);
+	} TestcaseEnd(concurrent_submitters);
+
+	// tasks submitted from workers go to their own deques and get stolen by the others
+	Testcase(nested_fork_join)
+	{
+		pool_t pool_(4);
+		auto root_ = pool_.submit([&pool_]() { return split_sum(pool_, 0, 100000); });
+		pool_.wait(root_);
+		ExpectEQ(root_.get(), 100000L * 99999L / 2);
+		ExpectEQ(split_sum(pool_, 0, 5000), 5000L * 4999L / 2);
+	} TestcaseEnd(nested_fork_join);
+
+	Testcase(destroy_drains_tasks)
+	{
+		ds::Atomic<int> done_ { 0 };
+		{
+			pool_t pool_(2);
+			for(int i = 0; i < 2000; ++i)
+			{
+				// handles released before the tasks run
+				pool_.submit([&done_]() { done_.fetch_add(1, ds::memory_order::relaxed); });
+			}
+			pool_.destroy();
+			ExpectTrue(!pool_);
+			ExpectTrue(!pool_.submit([]() {}));
+		}
+		ExpectEQ(done_.load(), 2000);
+	} TestcaseEnd(destroy_drains_tasks);
+
+	// one task at a time, idle workers spin briefly then park between the rounds
+	Testcase(parked_workers_woken)
+	{
+		pool_t pool_(4);
+		int sum_ = 0;
+		for(int round_ = 0; round_ < 200; ++round_)
+		{
+			auto task_ = pool_.submit([round_]() { return round_; });
+			task_.wait();
+			sum_ += task_.get();
+			// lets the workers park again
+			if(round_ % 50 == 0)
+				ds::sys::yield();
+		}
+		ExpectEQ(sum_, 200 * 199 / 2);
+	} TestcaseEnd(parked_workers_woken);
+
+};
+
+TestRegistry(thread_pool_test)
+{
+	Register(null_pool)
+	Register(submit_returns_results)
+	Register(overflow_global_queue)
+	Register(concurrent_submitters)
+	Register(nested_fork_join)
+	Register(destroy_drains_tasks)
+	Register(parked_workers_woken)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return thread_pool_test().run_all(reporter_t<thread_pool_test>(pptest::normal));
+}
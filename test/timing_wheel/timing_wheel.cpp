@@ -0,0 +1,207 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/timing_wheel>
+#include <ds/array>
+#include "../random"
+
+using wheel_timer_t = ds::Timer<>;
+using wheel_t = ds::TimingWheel<>;
+// 64 ticks over two levels, so that most timers cascade or wait in the overflow list
+using small_wheel_t = ds::TimingWheel<2,3>;
+
+template class ds::TimingWheel<>;
+template class ds::TimingWheel<2,3>;
+
+// random schedules, re-schedules, cancels and advances; every armed timer must fire once,
+//   at its deadline or on the next advance if the deadline had already passed.
+template <class W>
+static bool
+fires_on_deadline(uint64_t start_, size_t steps_, uint32_t seed_, uint32_t range_)
+{
+	size_t const count_ = 200;
+	wheel_timer_t timers_[count_];
+	auto expected_ = ds::Array<uint64_t>(count_, uint64_t(0));
+	W wheel_ { start_ };
+	uint64_t last_fire_ = start_;
+	bool     exact_     = true;
+	for(size_t i = 0; i < count_; ++i)
+	{
+		timers_[i].set_callback([&wheel_, &expected_, &last_fire_, &exact_, i]() {
+			exact_     = exact_ && wheel_.now() == expected_[i] && last_fire_ <= wheel_.now();
+			last_fire_ = wheel_.now();
+		});
+	}
+	for(size_t step_ = 0; step_ < steps_; ++step_)
+	{
+		size_t const   i   = next_random(seed_) % count_;
+		uint32_t const op_ = next_random(seed_) % 8;
+		if(op_ <= 3)
+		{
+			// now and then a deadline already passed
+			uint64_t const now_      = wheel_.now();
+			uint64_t const offset_   = next_random(seed_) % range_;
+			uint64_t const deadline_ = op_ == 0 && now_ >= 3 ? now_ - offset_ % 3 : now_ + offset_;
+			wheel_.schedule(timers_[i], deadline_);
+			expected_[i] = deadline_ > now_ ? deadline_ : now_;
+			if(!timers_[i].is_armed() || timers_[i].deadline() != deadline_)
+				return false;
+		}
+		else if(op_ == 4)
+		{
+			bool const armed_ = timers_[i].is_armed();
+			if(wheel_.cancel(timers_[i]) != armed_ || timers_[i].is_armed())
+				return false;
+		}
+		else
+		{
+			size_t armed_ = 0;
+			for(auto & timer_ : timers_)
+				armed_ += timer_.is_armed();
+			if(armed_ != wheel_.size())
+				return false;
+			uint64_t const to_ = wheel_.now() + next_random(seed_) % (range_ / 8 + 1);
+			size_t const fired_ = wheel_.advance(to_);
+			if(wheel_.now() != to_ || wheel_.size() != armed_ - fired_)
+				return false;
+			// nothing due by now is left armed
+			for(auto & timer_ : timers_)
+				if(timer_.is_armed() && timer_.deadline() <= to_)
+					return false;
+		}
+	}
+	wheel_.advance(wheel_.now() + range_ + 1);
+	for(auto & timer_ : timers_)
+		if(timer_.is_armed())
+			return false;
+	return wheel_.size() == 0 && exact_;
+}
+
+Test(timing_wheel_test)
+{
+	TestInit(timing_wheel_test);
+
+	Testcase(empty_wheel)
+	{
+		wheel_t wheel_;
+		ExpectTrue(!wheel_);
+		ExpectEQ(wheel_.size(), 0);
+		ExpectEQ(wheel_.advance(1000), 0);
+		ExpectEQ(wheel_.now(), 1000);
+		wheel_timer_t timer_;
+		ExpectFalse(timer_.is_armed());
+		ExpectFalse(wheel_.cancel(timer_));
+		// a timer without a callback still expires
+		wheel_.schedule_after(timer_, 5);
+		ExpectTrue(timer_.is_armed());
+		ExpectEQ(timer_.deadline(), 1005);
+		ExpectEQ(wheel_.advance(1004), 0);
+		ExpectEQ(wheel_.advance(1005), 1);
+		ExpectFalse(timer_.is_armed());
+		ExpectTrue(!wheel_);
+	} TestcaseEnd(empty_wheel);
+
+	Testcase(fires_on_deadline_small)
+	{
+		ExpectTrue(fires_on_deadline<small_wheel_t>(0, 20000, 1, 64));
+		ExpectTrue(fires_on_deadline<small_wheel_t>(0, 20000, 2, 5000));
+		// right before the top level and the overflow list wrap
+		ExpectTrue(fires_on_deadline<small_wheel_t>(64 * 1000 - 7, 20000, 3, 500));
+	} TestcaseEnd(fires_on_deadline_small);
+
+	Testcase(fires_on_deadline_default)
+	{
+		ExpectTrue(fires_on_deadline<wheel_t>(0, 20000, 4, 1000));
+		ExpectTrue(fires_on_deadline<wheel_t>(0, 20000, 5, 1u << 20));
+		ExpectTrue(fires_on_deadline<wheel_t>((uint64_t(1) << 32) - 100, 20000, 6, 1u << 16));
+	} TestcaseEnd(fires_on_deadline_default);
+
+	// whole levels without timers are jumped over rather than ticked through
+	Testcase(far_deadlines)
+	{
+		wheel_t wheel_;
+		uint64_t fired_[3] {};
+		wheel_timer_t near_ { [&wheel_, &fired_]() { fired_[0] = wheel_.now(); } };
+		wheel_timer_t far_  { [&wheel_, &fired_]() { fired_[1] = wheel_.now(); } };
+		wheel_timer_t over_ { [&wheel_, &fired_]() { fired_[2] = wheel_.now(); } };
+		uint64_t const far_deadline_  = (uint64_t(1) << 31) + 12345;
+		uint64_t const over_deadline_ = (uint64_t(1) << 40) + 777;
+		wheel_.schedule(over_, over_deadline_);
+		wheel_.schedule(far_, far_deadline_);
+		wheel_.schedule(near_, 3);
+		ExpectEQ(wheel_.advance(uint64_t(1) << 41), 3);
+		ExpectEQ(fired_[0], 3);
+		ExpectEQ(fired_[1], far_deadline_);
+		ExpectEQ(fired_[2], over_deadline_);
+		ExpectEQ(wheel_.now(), uint64_t(1) << 41);
+	} TestcaseEnd(far_deadlines);
+
+	Testcase(periodic_callback)
+	{
+		small_wheel_t wheel_;
+		size_t   fires_ = 0;
+		uint64_t last_  = 0;
+		bool     exact_ = true;
+		wheel_timer_t timer_;
+		timer_.set_callback([&]() {
+			++fires_;
+			exact_ = exact_ && wheel_.now() == last_ + 7;
+			last_  = wheel_.now();
+			if(fires_ < 100)
+				wheel_.schedule_after(timer_, 7);
+		});
+		wheel_.schedule_after(timer_, 7);
+		ExpectEQ(wheel_.advance(10000), 100);
+		ExpectEQ(fires_, 100);
+		ExpectTrue(exact_);
+		ExpectFalse(timer_.is_armed());
+	} TestcaseEnd(periodic_callback);
+
+	// callbacks cancel timers due on the same tick, and arm timers already due
+	Testcase(callbacks_edit_wheel)
+	{
+		wheel_t wheel_;
+		size_t fires_[3] {};
+		wheel_timer_t second_ { [&fires_]() { ++fires_[1]; } };
+		wheel_timer_t due_    { [&fires_]() { ++fires_[2]; } };
+		wheel_timer_t first_  { [&]() {
+			++fires_[0];
+			wheel_.cancel(second_);
+			wheel_.schedule(due_, wheel_.now());
+		} };
+		wheel_.schedule(first_, 10);
+		wheel_.schedule(second_, 10);
+		ExpectEQ(wheel_.size(), 2);
+		// the timer armed from the callback fires before advance() returns
+		ExpectEQ(wheel_.advance(10), 2);
+		ExpectEQ(fires_[0], 1);
+		ExpectEQ(fires_[1], 0);
+		ExpectEQ(fires_[2], 1);
+		ExpectTrue(!wheel_);
+		// re-arming moves the deadline instead of adding a timer
+		wheel_.schedule(second_, 50);
+		wheel_.schedule(second_, 20);
+		ExpectEQ(wheel_.size(), 1);
+		ExpectEQ(wheel_.advance(20), 1);
+		ExpectEQ(fires_[1], 1);
+		ExpectEQ(wheel_.advance(100), 0);
+	} TestcaseEnd(callbacks_edit_wheel);
+
+};
+
+TestRegistry(timing_wheel_test)
+{
+	Register(empty_wheel)
+	Register(fires_on_deadline_small)
+	Register(fires_on_deadline_default)
+	Register(far_deadlines)
+	Register(periodic_callback)
+	Register(callbacks_edit_wheel)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return timing_wheel_test().run_all(reporter_t<timing_wheel_test>(pptest::normal));
+}
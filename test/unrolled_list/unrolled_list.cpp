@@ -0,0 +1,192 @@
+#include <pptest>
+#include <colored_printer>
+#include <ds/common>
+#include <ds/unrolled_list>
+#include "../counter"
+
+template class ds::UnrolledList<int>;
+template class ds::UnrolledList<int,ds::default_allocator,4>;
+
+// small nodes so that a few elements split and merge them
+using list_t = ds::UnrolledList<int,ds::default_allocator,4>;
+
+// elements of list_ in order, compared with the expected ones
+template <size_t size_>
+static bool
+same_elements(list_t const & list_, int const (& expected_)[size_])
+{
+	if(list_.size() != size_)
+		return false;
+	size_t i = 0;
+	for(auto & value_ : list_)
+		if(i >= size_ || value_ != expected_[i++])
+			return false;
+	return i == size_;
+}
+
+Test(unrolled_list_test)
+{
+	TestInit(unrolled_list_test);
+
+	PreRun()
+	{
+		Counter::reset();
+	}
+
+	Testcase(default_construct_empty)
+	{
+		auto list_ = list_t();
+		ExpectEQ(list_.size(), 0);
+		ExpectTrue(!list_);
+		ExpectTrue(list_.begin() == list_.end());
+		ExpectTrue(list_.rbegin() == list_.rend());
+		ExpectFalse(list_.remove_first());
+		ExpectFalse(list_.remove_last());
+	} TestcaseEnd(default_construct_empty);
+
+	Testcase(insert_last_and_first)
+	{
+		auto list_ = list_t();
+		for(int i = 0; i < 10; ++i)
+			AssertTrue(bool(list_.insert_last(i)));
+		for(int i = -1; i >= -10; --i)
+			AssertTrue(bool(list_.insert_first(i)));
+		AssertEQ(list_.size(), 20);
+		int i = -10;
+		for(auto & value_ : list_)
+			ExpectEQ(value_, i++);
+		ExpectEQ(i, 10);
+		i = 9;
+		for(auto it = list_.rbegin(); it != list_.rend(); --it)
+			ExpectEQ(*it, i--);
+		ExpectEQ(i, -11);
+	} TestcaseEnd(insert_last_and_first);
+
+	Testcase(insert_in_full_nodes_splits)
+	{
+		auto list_ = list_t({ 0, 1, 2, 3, 4, 5, 6, 7 });
+		AssertTrue(bool(list_.emplace_before(list_.position_of(2), 10)));
+		AssertTrue(bool(list_.emplace_after(list_.position_of(5), 11)));
+		AssertTrue(bool(list_.emplace_before(list_.end(), 12)));
+		AssertTrue(bool(list_.emplace_after(list_.rend(), 13)));
+		ExpectTrue(same_elements(list_, { 13, 0, 1, 10, 2, 3, 4, 5, 11, 6, 7, 12 }));
+	} TestcaseEnd(insert_in_full_nodes_splits);
+
+	Testcase(remove_merges_nodes)
+	{
+		auto list_ = list_t();
+		for(int i = 0; i < 40; ++i)
+			AssertTrue(bool(list_.insert_last(i)));
+		for(int i = 0; i < 40; ++i)
+			if(i % 4 != 0)
+				AssertTrue(list_.remove_at(list_.position_of(i)));
+		ExpectTrue(same_elements(list_, { 0, 4, 8, 12, 16, 20, 24, 28, 32, 36 }));
+		ExpectFalse(list_.remove_at(list_.position_of(1)));
+		AssertTrue(list_.remove_first());
+		AssertTrue(list_.remove_last());
+		ExpectTrue(same_elements(list_, { 4, 8, 12, 16, 20, 24, 28, 32 }));
+		while(list_.remove_first());
+		ExpectEQ(list_.size(), 0);
+		ExpectTrue(!list_);
+	} TestcaseEnd(remove_merges_nodes);
+
+	// inserts and removes at pseudo-random positions against a plain array
+	Testcase(random_operations_match_array)
+	{
+		auto list_ = list_t();
+		int    model_[256];
+		size_t size_ = 0;
+		unsigned seed_ = 12345;
+		for(int step_ = 0; step_ < 2000; ++step_)
+		{
+			seed_ = seed_ * 1103515245u + 12345u;
+			size_t const at_ = size_ == 0 ? 0 : (seed_ >> 8) % size_;
+			auto it = list_.begin();
+			for(size_t i = 0; i < at_; ++i)
+				++it;
+			if(size_ < 200 && (size_ < 20 || (seed_ >> 4) % 3 != 0))
+			{
+				AssertTrue(bool(list_.emplace_before(it, step_)));
+				for(size_t i = size_; i > at_; --i)
+					model_[i] = model_[i - 1];
+				model_[at_] = step_;
+				++size_;
+			}
+			else
+			{
+				AssertTrue(list_.remove_at(it));
+				for(size_t i = at_ + 1; i < size_; ++i)
+					model_[i - 1] = model_[i];
+				--size_;
+			}
+			AssertEQ(list_.size(), size_);
+		}
+		size_t i = 0;
+		for(auto & value_ : list_)
+			ExpectEQ(value_, model_[i++]);
+		ExpectEQ(i, size_);
+	} TestcaseEnd(random_operations_match_array);
+
+	Testcase(position_of)
+	{
+		auto list_ = list_t({ 1, 2, 3, 2, 1 });
+		ExpectEQ(*list_.position_of(2), 2);
+		ExpectTrue(list_.position_of(2) != list_.rposition_of(2));
+		ExpectTrue(list_.position_of(4) == list_.end());
+		ExpectTrue(list_.rposition_of(4) == list_.rend());
+		auto it = list_.rposition_of(1);
+		ExpectTrue(++it == list_.end());
+	} TestcaseEnd(position_of);
+
+	Testcase(copy_move_and_concatenate)
+	{
+		auto list_ = list_t({ 1, 2, 3, 4, 5 });
+		auto copy_ = list_;
+		ExpectTrue(same_elements(copy_, { 1, 2, 3, 4, 5 }));
+		auto moved_ = ds::move(copy_);
+		ExpectTrue(!copy_);
+		ExpectEQ(moved_.size(), 5);
+		auto sum_ = list_t(list_, ds::move(moved_));
+		ExpectTrue(same_elements(sum_, { 1, 2, 3, 4, 5, 1, 2, 3, 4, 5 }));
+		copy_ = sum_;
+		ExpectEQ(copy_.size(), 10);
+	} TestcaseEnd(copy_move_and_concatenate);
+
+	Testcase(destroy_destructs_all)
+	{
+		{
+			auto list_ = ds::UnrolledList<Counter,ds::default_allocator,4>();
+			for(int i = 0; i < 30; ++i)
+				AssertTrue(bool(list_.emplace_last(i)));
+			ExpectEQ(Counter::active(), 30);
+			for(int i = 0; i < 10; ++i)
+				AssertTrue(list_.remove_first());
+			ExpectEQ(Counter::active(), 20);
+			auto copy_ = list_;
+			ExpectEQ(Counter::active(), 40);
+			copy_.destroy();
+			ExpectEQ(Counter::active(), 20);
+		}
+		ExpectEQ(Counter::active(), 0);
+	} TestcaseEnd(destroy_destructs_all);
+
+};
+
+TestRegistry(unrolled_list_test)
+{
+	Register(default_construct_empty)
+	Register(insert_last_and_first)
+	Register(insert_in_full_nodes_splits)
+	Register(remove_merges_nodes)
+	Register(random_operations_match_array)
+	Register(position_of)
+	Register(copy_move_and_concatenate)
+	Register(destroy_destructs_all)
+};
+
+template <class C> using reporter_t = pptest::colored_printer<C>;
+
+int main()
+{
+	return unrolled_list_test().run_all(reporter_t<unrolled_list_test>(pptest::normal));
+}